@@ -0,0 +1,20 @@
+TEMPLATE = app
+TARGET = LTTPMapTrackerBenchmark
+CONFIG += console c++14 precompile_header
+CONFIG -= app_bundle
+QT += core gui
+
+ROOT = $$PWD/../../..
+
+DEFINES += UTILITY_NO_NAMESPACE
+INCLUDEPATH += $$ROOT/Source
+PRECOMPILED_HEADER = $$ROOT/Source/CorePCH.h
+
+# The binary stays in the build directory; data paths resolve against the source root.
+DEFINES += BENCHMARK_ROOT=\\\"$$clean_path($$ROOT)\\\"
+
+SOURCES += \
+	$$ROOT/Source/Benchmark/Main.cpp
+
+LIBS += -L$$OUT_PWD/../Core -lLTTPMapTrackerCore
+PRE_TARGETDEPS += $$OUT_PWD/../Core/libLTTPMapTrackerCore.a
@@ -0,0 +1,59 @@
+TEMPLATE = lib
+TARGET = LTTPMapTrackerCore
+CONFIG += staticlib c++14 precompile_header
+QT += core gui
+
+ROOT = $$PWD/../../..
+
+DEFINES += UTILITY_NO_NAMESPACE
+INCLUDEPATH += $$ROOT/Source
+PRECOMPILED_HEADER = $$ROOT/Source/CorePCH.h
+
+HEADERS += \
+	$$ROOT/Source/EditorTypeInfo.h \
+	$$ROOT/Source/Data/Configuration.h \
+	$$ROOT/Source/Data/DataModel.h \
+	$$ROOT/Source/Data/Settings.h \
+	$$ROOT/Source/Data/Database/EntityDatabase.h \
+	$$ROOT/Source/Data/Database/ItemDatabase.h \
+	$$ROOT/Source/Data/Database/LocationDatabase.h \
+	$$ROOT/Source/Data/Instance/Instance.h \
+	$$ROOT/Source/Data/Instance/InstanceData.h \
+	$$ROOT/Source/Data/Instance/InstanceDependencyGraph.h \
+	$$ROOT/Source/Data/Instance/InstanceEvaluator.h \
+	$$ROOT/Source/Data/Instance/InstanceProgressState.h \
+	$$ROOT/Source/Data/Instance/InstanceRuleParser.h \
+	$$ROOT/Source/Data/Instance/InstanceSnapshot.h \
+	$$ROOT/Source/Data/Instance/InstanceTypeInfo.h \
+	$$ROOT/Source/Data/Schema/Schema.h \
+	$$ROOT/Source/Data/Schema/SchemaData.h \
+	$$ROOT/Source/Data/Schema/SchemaRuleProgram.h \
+	$$ROOT/Source/Data/Schema/SchemaTypeInfo.h \
+	$$ROOT/Source/Utility/DataContainer.h \
+	$$ROOT/Source/Utility/DataWrapper.h \
+	$$ROOT/Source/Utility/EnumReflection.h \
+	$$ROOT/Source/Utility/File.h \
+	$$ROOT/Source/Utility/JSON.h \
+	$$ROOT/Source/Utility/Result.h \
+	$$ROOT/Source/Utility/Utility.h
+
+SOURCES += \
+	$$ROOT/Source/Data/Configuration.cpp \
+	$$ROOT/Source/Data/DataModel.cpp \
+	$$ROOT/Source/Data/Settings.cpp \
+	$$ROOT/Source/Data/Database/EntityDatabase.cpp \
+	$$ROOT/Source/Data/Database/ItemDatabase.cpp \
+	$$ROOT/Source/Data/Database/LocationDatabase.cpp \
+	$$ROOT/Source/Data/Instance/Instance.cpp \
+	$$ROOT/Source/Data/Instance/InstanceData.cpp \
+	$$ROOT/Source/Data/Instance/InstanceDependencyGraph.cpp \
+	$$ROOT/Source/Data/Instance/InstanceEvaluator.cpp \
+	$$ROOT/Source/Data/Instance/InstanceProgressState.cpp \
+	$$ROOT/Source/Data/Instance/InstanceRuleParser.cpp \
+	$$ROOT/Source/Data/Instance/InstanceSnapshot.cpp \
+	$$ROOT/Source/Data/Schema/Schema.cpp \
+	$$ROOT/Source/Data/Schema/SchemaData.cpp \
+	$$ROOT/Source/Data/Schema/SchemaRuleProgram.cpp \
+	$$ROOT/Source/Utility/File.cpp \
+	$$ROOT/Source/Utility/JSON.cpp \
+	$$ROOT/Source/Utility/Result.cpp
@@ -0,0 +1,11 @@
+# Headless builds of the tracker's data and logic, for platforms without the MSVC project.
+#
+#   mkdir Build && cd Build && qmake ../Platform/QMake/LTTPMapTracker.pro && make
+#
+# Core        Static library holding the data model, schema, instance and rule engine.
+# Benchmark   Times accessibility caching, loading and saving against the bundled configurations.
+
+TEMPLATE = subdirs
+SUBDIRS = Core Benchmark
+
+Benchmark.depends = Core
@@ -0,0 +1,182 @@
+// Project includes
+#include "Data/Configuration.h"
+#include "Data/DataModel.h"
+#include "Data/Instance/Instance.h"
+
+// Qt includes
+#include <QDir>
+#include <QElapsedTimer>
+#include <QGuiApplication>
+#include <QTemporaryDir>
+#include <QTextStream>
+
+// Stdlib includes
+#include <algorithm>
+#include <limits>
+
+
+namespace LTTPMapTracker
+{
+	//================================================================================
+	// Timing
+	//================================================================================
+
+	struct BenchmarkTiming
+	{
+		qint64	m_min;
+		qint64	m_max;
+		qint64	m_total;
+		int		m_count;
+
+		BenchmarkTiming()
+			: m_min(std::numeric_limits<qint64>::max())
+			, m_max(0)
+			, m_total(0)
+			, m_count(0)
+		{
+		}
+
+		void add(qint64 nsecs)
+		{
+			m_min = std::min(m_min, nsecs);
+			m_max = std::max(m_max, nsecs);
+			m_total += nsecs;
+			++m_count;
+		}
+	};
+
+	template <typename Func>
+	BenchmarkTiming benchmark(int iterations, Func func)
+	{
+		BenchmarkTiming timing;
+		QElapsedTimer timer;
+
+		for (int i = 0; i < iterations; ++i)
+		{
+			timer.start();
+			func();
+			timing.add(timer.nsecsElapsed());
+		}
+
+		return timing;
+	}
+
+	void report(QTextStream& out, QString configuration, QString operation, const BenchmarkTiming& timing)
+	{
+		auto ms = [] (qint64 nsecs) { return QString::number(nsecs / 1000000.0, 'f', 3); };
+
+		out << QString("%1 %2").arg(configuration, -12).arg(operation, -24)
+			<< " min " << ms(timing.m_min)
+			<< " ms, mean " << ms(timing.m_count > 0 ? timing.m_total / timing.m_count : 0)
+			<< " ms, max " << ms(timing.m_max)
+			<< " ms (" << timing.m_count << " iterations)\n";
+		out.flush();
+	}
+
+	bool report_errors(QTextStream& out, QString context, const Result& result)
+	{
+		if (result)
+		{
+			return false;
+		}
+
+		for (auto& entry : result.get_entries())
+		{
+			out << context << ": " << entry.m_message << "\n";
+		}
+
+		out.flush();
+		return true;
+	}
+
+
+
+	//================================================================================
+	// Configuration
+	//================================================================================
+
+	bool benchmark_configuration(QTextStream& out, const DataModel& data_model, QString name, QString filename, int iterations)
+	{
+		Configuration configuration(data_model);
+
+		if (report_errors(out, name, configuration.load(get_absolute_path(filename))) ||
+			report_errors(out, name, configuration.create_instance()))
+		{
+			return false;
+		}
+
+		auto instance = configuration.get().m_instance;
+
+		QTemporaryDir dir;
+		auto instance_filename = dir.filePath(name + ".instance.json");
+
+		if (report_errors(out, name, instance->save(instance_filename)))
+		{
+			return false;
+		}
+
+		report(out, name, "cache_accessibility", benchmark(iterations, [&instance] ()
+		{
+			instance->recache_accessibility();
+		}));
+
+		report(out, name, "load", benchmark(iterations, [&instance, &instance_filename] ()
+		{
+			instance->load(instance_filename);
+		}));
+
+		report(out, name, "save", benchmark(iterations, [&instance, &instance_filename] ()
+		{
+			instance->save(instance_filename);
+		}));
+
+		return true;
+	}
+}
+
+
+
+//================================================================================
+// Main
+//================================================================================
+
+int main(int argc, char** argv)
+{
+	using namespace LTTPMapTracker;
+
+	// Entity images are pixmaps, which need a GUI application but not a display.
+	if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM"))
+	{
+		qputenv("QT_QPA_PLATFORM", "offscreen");
+	}
+
+	QGuiApplication app(argc, argv);
+	set_base_path(BENCHMARK_ROOT);
+	QDir::setCurrent(get_base_path());
+
+	QTextStream out(stdout);
+
+	int iterations = (argc > 1 ? QString(argv[1]).toInt() : 100);
+	if (iterations <= 0)
+	{
+		out << "Usage: " << argv[0] << " [iterations]\n";
+		return 1;
+	}
+
+	DataModel data_model;
+
+	auto load_results = data_model.load();
+	for (auto it = load_results.begin(); it != load_results.end(); ++it)
+	{
+		if (report_errors(out, it.key(), it.value()))
+		{
+			return 1;
+		}
+	}
+
+	bool result = true;
+	result &= benchmark_configuration(out, data_model, "Open", "Data/Configurations/Open/Open.configuration.json", iterations);
+	result &= benchmark_configuration(out, data_model, "Entrance", "Data/Configurations/Entrance/EntranceFull.configuration.json", iterations);
+
+	return (result ? 0 : 1);
+}
\ No newline at end of file
@@ -0,0 +1,22 @@
+#ifndef CORE_PCH_H
+#define CORE_PCH_H
+
+// Precompiled header for the data and logic, which build without widgets.
+
+// Project includes
+#include "Utility/ModelData/ModelData.h"
+#include "Utility/DataContainer.h"
+#include "Utility/DataWrapper.h"
+#include "Utility/EnumReflection.h"
+#include "Utility/File.h"
+#include "Utility/JSON.h"
+#include "Utility/Result.h"
+
+// Qt includes
+#include <QtCore>
+
+// Stdlib includes
+#include <functional>
+#include <memory>
+
+#endif
\ No newline at end of file
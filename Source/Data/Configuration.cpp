@@ -2,6 +2,7 @@
 #include "Data/Configuration.h"
 #include "Data/Instance/Instance.h"
 #include "Data/Schema/Schema.h"
+#include "Data/DataModel.h"
 #include "Utility/File.h"
 #include "Utility/JSON.h"
 
@@ -26,7 +27,7 @@ namespace LTTPMapTracker
 		json["SettingsOverrides"] = get_relative_path(m_settings_overrides);
 	}
 
-	Result ConfigurationData::deserialise(const QJsonObject& json, int /*version*/)
+	Result ConfigurationData::deserialise(const QJsonObject& json, int /*version*/, const EntityDatabase& entity_db)
 	{
 		Result result;
 
@@ -35,7 +36,7 @@ namespace LTTPMapTracker
 
 		if (!schema_filename.isEmpty())
 		{
-			result << m_schema->load(get_absolute_path(schema_filename));
+			result << m_schema->load(get_absolute_path(schema_filename), entity_db);
 		}
 		
 		result << json_read(json, "Name", m_name, QString());
@@ -113,7 +114,7 @@ namespace LTTPMapTracker
 			return Result(false, "Unable to read version.");
 		}
 
-		auto deserialise_result = deserialise(json, version);
+		auto deserialise_result = deserialise(json, version, m_internal->m_data_model.get_entity_db());
 		if (!deserialise_result)
 		{
 			return deserialise_result;
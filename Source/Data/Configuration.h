@@ -5,6 +5,12 @@
 #include "Utility/DataWrapper.h"
 #include "EditorTypeInfo.h"
 
+// Forward declarations
+namespace LTTPMapTracker
+{
+	class EntityDatabase;
+}
+
 
 namespace LTTPMapTracker
 {
@@ -22,7 +28,7 @@ namespace LTTPMapTracker
 		
 				ConfigurationData	();
 		void	serialise			(QJsonObject& json) const;
-		Result	deserialise			(const QJsonObject& json, int version);
+		Result	deserialise			(const QJsonObject& json, int version, const EntityDatabase& entity_db);
 	};
 
 
@@ -17,6 +17,17 @@ namespace LTTPMapTracker
 
 
 
+	//================================================================================
+	// Entity
+	//================================================================================
+
+	Entity::Entity()
+		: m_id(-1)
+	{
+	}
+
+
+
 	//================================================================================
 	// Loading
 	//================================================================================
@@ -82,8 +93,13 @@ namespace LTTPMapTracker
 			entities.insert(type_name, entity);
 		}
 
-		// Store entities.
-		std::copy(entities.begin(), entities.end(), std::back_inserter(m_entities));
+		// Store entities. Ids are dense indices into the entity list.
+		for (auto entity : entities)
+		{
+			entity->m_id = m_entities.size();
+			m_entities << entity;
+			m_entities_by_name.insert(entity->m_type_name, entity);
+		}
 
 		return result;
 	}
@@ -96,15 +112,21 @@ namespace LTTPMapTracker
 
 	EntityCPtr EntityDatabase::get_entity(QString type_name) const
 	{
-		auto it = std::find_if(m_entities.begin(), m_entities.end(), [type_name] (EntityCPtr entity)
-		{
-			return (entity->m_type_name == type_name);
-		});
-		return (it != m_entities.end() ? *it : nullptr);
+		return m_entities_by_name.value(type_name);
 	}
 
-	EntityList EntityDatabase::get_entities() const
+	EntityCPtr EntityDatabase::get_entity(int id) const
+	{
+		return (id >= 0 && id < m_entities.size() ? m_entities[id] : nullptr);
+	}
+
+	const EntityList& EntityDatabase::get_entities() const
 	{
 		return m_entities;
 	}
+
+	int EntityDatabase::get_num_entities() const
+	{
+		return m_entities.size();
+	}
 }
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include "Utility/Result.h"
 
 // Qt includes
+#include <QHash>
 #include <QPixmap>
 #include <QString>
 
@@ -23,9 +24,12 @@ namespace LTTPMapTracker
 
 	struct Entity
 	{
+		int		m_id;
 		QString	m_type_name;
 		QString	m_display_name;
 		QPixmap	m_image;
+
+		Entity();
 	};
 
 
@@ -36,14 +40,17 @@ namespace LTTPMapTracker
 	{
 	public:
 		// Loading
-		Result		load			();
+		Result				load				();
 
 		// Entity
-		EntityCPtr	get_entity		(QString type_name) const;
-		EntityList	get_entities	()					const;
+		EntityCPtr			get_entity			(QString type_name) const;
+		EntityCPtr			get_entity			(int id)			const;
+		const EntityList&	get_entities		()					const;
+		int					get_num_entities	()					const;
 
 	private:
-		EntityList	m_entities;
+		EntityList					m_entities;
+		QHash<QString, EntityCPtr>	m_entities_by_name;
 	};
 }
 
@@ -70,9 +70,17 @@ namespace LTTPMapTracker
 			items.insert(entity_name, item);
 		}
 
-		// Store items.
+		// Store items, indexed by type name and by entity id.
 		std::copy(items.begin(), items.end(), std::back_inserter(m_items));
 
+		m_items_by_entity.fill(nullptr, entity_db.get_num_entities());
+
+		for (auto item : m_items)
+		{
+			m_items_by_name.insert(item->m_entity->m_type_name, item);
+			m_items_by_entity[item->m_entity->m_id] = item;
+		}
+
 		return result;
 	}
 
@@ -84,23 +92,15 @@ namespace LTTPMapTracker
 
 	ItemCPtr ItemDatabase::get_item(QString type_name) const
 	{
-		auto it = std::find_if(m_items.begin(), m_items.end(), [type_name] (ItemCPtr item)
-		{
-			return (item->m_entity->m_type_name == type_name);
-		});
-		return (it != m_items.end() ? *it : nullptr);
+		return m_items_by_name.value(type_name);
 	}
 
 	ItemCPtr ItemDatabase::get_item(EntityCPtr entity) const
 	{
-		auto it = std::find_if(m_items.begin(), m_items.end(), [entity] (ItemCPtr item)
-		{
-			return (item->m_entity == entity);
-		});
-		return (it != m_items.end() ? *it : nullptr);
+		return (entity != nullptr && entity->m_id >= 0 && entity->m_id < m_items_by_entity.size() ? m_items_by_entity[entity->m_id] : nullptr);
 	}
 
-	ItemList ItemDatabase::get_items() const
+	const ItemList& ItemDatabase::get_items() const
 	{
 		return m_items;
 	}
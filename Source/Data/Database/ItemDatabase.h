@@ -2,11 +2,12 @@
 #define ITEM_DATABASE_H
 
 // Project includes
-#include "data/Instance/InstanceTypeInfo.h"
+#include "Data/Instance/InstanceTypeInfo.h"
 #include "Data/Database/EntityDatabase.h"
 #include "Utility/Result.h"
 
 // Qt includes
+#include <QHash>
 #include <QPixmap>
 #include <QString>
 
@@ -36,15 +37,17 @@ namespace LTTPMapTracker
 	{
 	public:
 		// Loading
-		Result		load		(const EntityDatabase& entity_db);
+		Result				load		(const EntityDatabase& entity_db);
 
 		// Data
-		ItemCPtr	get_item	(QString type_name) const;
-		ItemCPtr	get_item	(EntityCPtr entity) const;
-		ItemList	get_items	()					const;
+		ItemCPtr			get_item	(QString type_name) const;
+		ItemCPtr			get_item	(EntityCPtr entity) const;
+		const ItemList&		get_items	()					const;
 
 	private:
-		ItemList	m_items;
+		ItemList					m_items;
+		QHash<QString, ItemCPtr>	m_items_by_name;
+		ItemList					m_items_by_entity;
 	};
 }
 
@@ -13,6 +13,10 @@
 #include <QMap>
 
 
+// Stdlib includes
+#include <numeric>
+
+
 namespace LTTPMapTracker
 {
 	//================================================================================
@@ -157,11 +161,48 @@ namespace LTTPMapTracker
 				result << deserialise_location_requirements(connection.m_requirements, json_connection[2].toArray(), entity_db);
 				location->m_connections << connection;
 			}
+
+			// Entrance graph over the connections.
+			auto& graph = location->m_entrance_graph;
+			auto entrance_index = [&graph] (EntityCPtr entrance)
+			{
+				auto it = graph.m_entrance_indices.find(entrance.get());
+				if (it == graph.m_entrance_indices.end())
+				{
+					it = graph.m_entrance_indices.insert(entrance.get(), graph.m_entrance_connections.size());
+					graph.m_entrance_connections << QVector<int>();
+				}
+
+				return it.value();
+			};
+
+			for (int i = 0; i < location->m_connections.size(); ++i)
+			{
+				auto& entrances = location->m_connections[i].m_entrances;
+				int index1 = entrance_index(entrances[0]);
+				int index2 = entrance_index(entrances[1]);
+
+				graph.m_connection_entrances << qMakePair(index1, index2);
+				graph.m_entrance_connections[index1] << i;
+
+				if (index2 != index1)
+				{
+					graph.m_entrance_connections[index2] << i;
+				}
+			}
 		}
 
-		// Store locations.
+		// Store locations, indexed by type name and by entity id.
 		std::copy(locations.begin(), locations.end(), std::back_inserter(m_locations));
 
+		m_locations_by_entity.fill(nullptr, entity_db.get_num_entities());
+
+		for (auto location : m_locations)
+		{
+			m_locations_by_name.insert(location->m_entity->m_type_name, location);
+			m_locations_by_entity[location->m_entity->m_id] = location;
+		}
+
 		return result;
 	}
 
@@ -173,23 +214,15 @@ namespace LTTPMapTracker
 
 	LocationCPtr LocationDatabase::get_location(QString type_name) const
 	{
-		auto it = std::find_if(m_locations.begin(), m_locations.end(), [type_name] (LocationCPtr location)
-		{
-			return (location->m_entity->m_type_name == type_name);
-		});
-		return (it != m_locations.end() ? *it : nullptr);
+		return m_locations_by_name.value(type_name);
 	}
 
 	LocationCPtr LocationDatabase::get_location(EntityCPtr entity) const
 	{
-		auto it = std::find_if(m_locations.begin(), m_locations.end(), [entity] (LocationCPtr location)
-		{
-			return (location->m_entity == entity);
-		});	
-		return (it != m_locations.end() ? *it : nullptr);
+		return (entity != nullptr && entity->m_id >= 0 && entity->m_id < m_locations_by_entity.size() ? m_locations_by_entity[entity->m_id] : nullptr);
 	}
 
-	LocationList LocationDatabase::get_locations() const
+	const LocationList& LocationDatabase::get_locations() const
 	{
 		return m_locations;
 	}
@@ -246,16 +279,17 @@ namespace LTTPMapTracker
 				bool optional = part_name.contains('?');
 				part_name.remove('?');
 
-				QVariant value;
+				int id = -1;
 				switch (type)
 				{
 				case LocationRequirementType::ProgressItem:
 				case LocationRequirementType::ProgressLocation:
 				default:
 					{
-						if (entity_db.get_entity(part_name) != nullptr)
+						auto entity = entity_db.get_entity(part_name);
+						if (entity != nullptr)
 						{
-							value = part_name;
+							id = entity->m_id;
 						}
 					}
 					break;
@@ -265,13 +299,13 @@ namespace LTTPMapTracker
 						auto info = EnumReflection<SchemaRuleTypeProgressSpecial>::info(part_name);
 						if (info != nullptr)
 						{
-							value = (int)info->m_type;
+							id = (int)info->m_type;
 						}
 					}
 					break;
 				}
 
-				if (value.isNull())
+				if (id == -1)
 				{
 					result << ResultEntry(ResultType::Warning, "Location requirement token not found: " + part_name);
 					continue;
@@ -279,7 +313,7 @@ namespace LTTPMapTracker
 
 				LocationRequirementEntry entry;
 				entry.m_type = type;
-				entry.m_value = value;
+				entry.m_id = id;
 				entry.m_optional = optional;
 				entries << entry;
 			}
@@ -295,7 +329,7 @@ namespace LTTPMapTracker
 		return result;
 	}
 
-	LocationMatch match_location_requirement(const LocationRequirement& requirement, const Instance& instance)
+	LocationMatch match_location_requirement(const LocationRequirement& requirement, const InstanceProgressState& progress_state)
 	{
 		auto result = LocationMatch::No;
 
@@ -306,28 +340,15 @@ namespace LTTPMapTracker
 			switch (entry.m_type)
 			{
 			case LocationRequirementType::ProgressItem:
-				{
-					auto progress_items = instance.progress_items().get();
-					entry_result = std::any_of(progress_items.begin(), progress_items.end(), [&entry] (InstanceProgressItemCPtr progress_item)
-					{
-						return (progress_item->get().m_item->m_entity->m_type_name == entry.m_value.toString());
-					});
-				}
+				entry_result = progress_state.has_item(entry.m_id);
 				break;
 
 			case LocationRequirementType::ProgressLocation:
-				{
-					auto progress_locations = instance.progress_locations().get();
-					entry_result = std::any_of(progress_locations.begin(), progress_locations.end(), [&entry] (InstanceProgressLocationCPtr progress_location)
-					{
-						return (progress_location->get().m_location->m_entity->m_type_name == entry.m_value.toString() &&
-								progress_location->get().m_cleared);
-					});
-				}
+				entry_result = progress_state.is_location_cleared(entry.m_id);
 				break;
 
 			case LocationRequirementType::ProgressSpecial:
-				entry_result = match_rule(instance, (SchemaRuleTypeProgressSpecial)entry.m_value.toInt());
+				entry_result = match_rule(progress_state, (SchemaRuleTypeProgressSpecial)entry.m_id);
 				break;
 			}
 
@@ -341,7 +362,7 @@ namespace LTTPMapTracker
 		return result;
 	}
 
-	LocationMatch match_location_requirements(const QVector<LocationRequirement>& requirements, const Instance& instance)
+	LocationMatch match_location_requirements(const QVector<LocationRequirement>& requirements, const InstanceProgressState& progress_state)
 	{
 		if (!requirements.isEmpty())
 		{
@@ -349,7 +370,7 @@ namespace LTTPMapTracker
 
 			for (auto& requirement : requirements)
 			{
-				auto requirement_result = match_location_requirement(requirement, instance);
+				auto requirement_result = match_location_requirement(requirement, progress_state);
 				if (requirement_result < result)
 				{
 					result = requirement_result;
@@ -363,4 +384,73 @@ namespace LTTPMapTracker
 			return LocationMatch::Maybe;
 		}
 	}
+
+	QVector<int> match_location_components(const Location& location, const InstanceProgressState& progress_state)
+	{
+		// Union the ends of every connection that isn't ruled out, then flatten so each
+		// entrance maps straight to the root of its component.
+		auto& graph = location.m_entrance_graph;
+
+		QVector<int> components(graph.m_entrance_connections.size());
+		std::iota(components.begin(), components.end(), 0);
+
+		auto find = [&components] (int index)
+		{
+			while (components[index] != index)
+			{
+				components[index] = components[components[index]];
+				index = components[index];
+			}
+
+			return index;
+		};
+
+		for (int i = 0; i < location.m_connections.size(); ++i)
+		{
+			if (match_location_requirements(location.m_connections[i].m_requirements, progress_state) != LocationMatch::No)
+			{
+				auto& entrances = graph.m_connection_entrances[i];
+				components[find(entrances.first)] = find(entrances.second);
+			}
+		}
+
+		for (int i = 0; i < components.size(); ++i)
+		{
+			components[i] = find(i);
+		}
+
+		return components;
+	}
+
+	bool is_location_connected(const Location& location, const QVector<int>& components, EntityCPtr from, EntityCPtr to)
+	{
+		auto& graph = location.m_entrance_graph;
+
+		int from_index = graph.m_entrance_indices.value(from.get(), -1);
+		int to_index = graph.m_entrance_indices.value(to.get(), -1);
+		if (from_index == -1 || to_index == -1)
+		{
+			return false;
+		}
+
+		if (from_index == to_index)
+		{
+			return true;
+		}
+
+		// A connection into the target counts even when its requirements aren't met;
+		// only passing through an entrance needs them.
+		for (int connection : graph.m_entrance_connections[to_index])
+		{
+			auto& entrances = graph.m_connection_entrances[connection];
+			int other_index = (entrances.first != to_index ? entrances.first : entrances.second);
+
+			if (components[other_index] == components[from_index])
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
 }
\ No newline at end of file
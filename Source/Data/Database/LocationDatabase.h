@@ -7,6 +7,8 @@
 #include "Utility/Result.h"
 
 // Qt includes
+#include <QHash>
+#include <QPair>
 #include <QPixmap>
 #include <QString>
 
@@ -30,10 +32,12 @@ namespace LTTPMapTracker
 		ProgressSpecial
 	};
 
+	// m_id holds the entity id for ProgressItem/ProgressLocation and the
+	// SchemaRuleTypeProgressSpecial for ProgressSpecial, both resolved at load.
 	struct LocationRequirementEntry
 	{
 		LocationRequirementType	m_type;
-		QVariant				m_value;
+		int						m_id;
 		bool					m_optional;
 	};
 
@@ -48,6 +52,15 @@ namespace LTTPMapTracker
 		QVector<LocationRequirement>	m_requirements;
 	};
 
+	// The entrances joined by a location's connections, numbered at load. Each connection
+	// pairs two entrance indices; each entrance lists the connections that touch it.
+	struct LocationEntranceGraph
+	{
+		QHash<const Entity*, int>	m_entrance_indices;
+		QVector<QPair<int, int>>	m_connection_entrances;
+		QVector<QVector<int>>		m_entrance_connections;
+	};
+
 	enum class LocationMatch
 	{
 		No,
@@ -65,6 +78,7 @@ namespace LTTPMapTracker
 		EntityList						m_entrances;
 		QVector<LocationRequirement>	m_requirements;
 		QVector<LocationConnection>		m_connections;
+		LocationEntranceGraph			m_entrance_graph;
 
 		Location();
 	};
@@ -77,15 +91,17 @@ namespace LTTPMapTracker
 	{
 	public:
 		// Loading
-		Result			load			(const EntityDatabase& entity_db);
+		Result				load			(const EntityDatabase& entity_db);
 
 		// Entity
-		LocationCPtr	get_location	(QString type_name) const;
-		LocationCPtr	get_location	(EntityCPtr entity) const;
-		LocationList	get_locations	()					const;
+		LocationCPtr		get_location	(QString type_name) const;
+		LocationCPtr		get_location	(EntityCPtr entity) const;
+		const LocationList&	get_locations	()					const;
 
 	private:
-		LocationList	m_locations;
+		LocationList					m_locations;
+		QHash<QString, LocationCPtr>	m_locations_by_name;
+		LocationList					m_locations_by_entity;
 	};
 
 
@@ -93,8 +109,10 @@ namespace LTTPMapTracker
 	//--------------------------------------------------------------------------------
 
 	Result			deserialise_location_requirements	(QVector<LocationRequirement>& requirements, const QJsonArray& json, const EntityDatabase& entity_db);
-	LocationMatch	match_location_requirement			(const LocationRequirement& requirement, const Instance& instance);
-	LocationMatch	match_location_requirements			(const QVector<LocationRequirement>& requirements, const Instance& instance);
+	LocationMatch	match_location_requirement			(const LocationRequirement& requirement, const InstanceProgressState& progress_state);
+	LocationMatch	match_location_requirements			(const QVector<LocationRequirement>& requirements, const InstanceProgressState& progress_state);
+	QVector<int>	match_location_components			(const Location& location, const InstanceProgressState& progress_state);
+	bool			is_location_connected				(const Location& location, const QVector<int>& components, EntityCPtr from, EntityCPtr to);
 }
 
 #endif
\ No newline at end of file
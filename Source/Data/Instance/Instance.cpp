@@ -1,5 +1,7 @@
 // Project includes
 #include "Data/Instance/Instance.h"
+#include "Data/Instance/InstanceDependencyGraph.h"
+#include "Data/Instance/InstanceEvaluator.h"
 #include "Data/Instance/InstanceRuleParser.h"
 #include "Data/Schema/Schema.h"
 #include "Data/DataModel.h"
@@ -10,6 +12,7 @@
 #include <QDateTime>
 #include <QDir>
 #include <QFile>
+#include <QHash>
 #include <QJsonArray>
 #include <QVector>
 
@@ -20,19 +23,32 @@ namespace LTTPMapTracker
 	// Utility
 	//================================================================================
 
-	bool compare_connection_item(InstanceConnectionCPtr connection, InstanceItemPtr item)
+	QVector<InstanceItemPtr> get_connection_keys(InstanceConnectionCPtr connection)
 	{
-		return connection->get().m_items.contains(item);
+		return connection->get().m_items;
 	}
 
-	bool compare_progress_item(InstanceProgressItemCPtr progress_item, EntityCPtr entity)
+	QVector<EntityCPtr> get_progress_item_keys(InstanceProgressItemCPtr progress_item)
 	{
-		return (progress_item->get().m_item->m_entity == entity);
+		auto item = progress_item->get().m_item;
+		return (item != nullptr ? QVector<EntityCPtr>() << item->m_entity : QVector<EntityCPtr>());
 	}
 
-	bool compare_progress_location(InstanceProgressLocationCPtr progress_location, EntityCPtr entity)
+	QVector<EntityCPtr> get_progress_location_keys(InstanceProgressLocationCPtr progress_location)
 	{
-		return (progress_location->get().m_location->m_entity == entity);
+		auto location = progress_location->get().m_location;
+		return (location != nullptr ? QVector<EntityCPtr>() << location->m_entity : QVector<EntityCPtr>());
+	}
+
+	int get_entity_id(InstanceProgressItemCPtr progress_item)
+	{
+		auto item = progress_item->get().m_item;
+		return (item != nullptr && item->m_entity != nullptr ? item->m_entity->m_id : -1);
+	}
+
+	int get_entity_id(const InstanceProgressLocationData& data)
+	{
+		return (data.m_location != nullptr && data.m_location->m_entity != nullptr ? data.m_location->m_entity->m_id : -1);
 	}
 }
 
@@ -52,20 +68,196 @@ namespace LTTPMapTracker
 		InstanceConnections			m_connections;
 		InstanceProgressItems		m_progress_items;
 		InstanceProgressLocations	m_progress_locations;
+		InstanceProgressState		m_progress_state;
+		InstanceDependencyGraph		m_dependency_graph;
+
+		// Accessibility evaluation. The snapshot is kept in step with the instance's data
+		// and copied for each pass; pending regions and items cover everything invalidated
+		// since the last pass that was applied.
+		InstanceEvaluator			m_evaluator;
+		InstanceSnapshot			m_snapshot;
+		QVector<bool>				m_region_accessible;
+		QVector<bool>				m_item_accessible;
+		QVector<bool>				m_pending_regions;
+		QVector<bool>				m_pending_items;
+		QVector<int>				m_pending_region_indices;
+		QVector<int>				m_pending_item_indices;
+		QVector<InstanceItemStatus>	m_item_status;
+		bool						m_report_all_items;
+
+		// Item pair each connection was added to the snapshot under, so it can be taken back out.
+		QHash<const InstanceConnection*, QPair<int, int>>			m_connection_indices;
+
+		// What each progress entry was last recorded as, so a modification can take the old one back out.
+		QHash<const InstanceProgressItem*, int>								m_progress_item_entities;
+		QHash<const InstanceProgressLocation*, InstanceProgressLocationData>	m_progress_location_data;
 
 		QString						m_filename;
 		QString						m_filename_auto;
 		bool						m_dirty;
 
+		int							m_batch_depth;
+		bool						m_batch_pending;
+
 		Internal(Instance& instance, const DataModel& data_model, SchemaCPtr schema)
 			: m_data_model(data_model)
 			, m_schema(schema)
-			, m_connections(std::bind(&Instance::create_connection, &instance, std::placeholders::_1), std::bind(&Instance::create_connection_empty, &instance), compare_connection_item)
-			, m_progress_items(std::bind(&Instance::create_progress_item, &instance, std::placeholders::_1), std::bind(&Instance::create_progress_item_empty, &instance), compare_progress_item)
-			, m_progress_locations(std::bind(&Instance::create_progress_location, &instance, std::placeholders::_1), std::bind(&Instance::create_progress_location_empty, &instance), compare_progress_location)
+			, m_connections(std::bind(&Instance::create_connection, &instance, std::placeholders::_1), std::bind(&Instance::create_connection_empty, &instance), get_connection_keys)
+			, m_progress_items(std::bind(&Instance::create_progress_item, &instance, std::placeholders::_1), std::bind(&Instance::create_progress_item_empty, &instance), get_progress_item_keys)
+			, m_progress_locations(std::bind(&Instance::create_progress_location, &instance, std::placeholders::_1), std::bind(&Instance::create_progress_location_empty, &instance), get_progress_location_keys)
+			, m_dependency_graph(instance)
 			, m_filename_auto(get_absolute_path(QString("Data/Instances/AutoSave/%1.instance.json").arg(QDateTime::currentDateTime().toString("yyyy-MM-dd-HH-mm-ss"))))
 			, m_dirty(false)
+			, m_report_all_items(true)
+			, m_batch_depth(0)
+			, m_batch_pending(false)
+		{
+		}
+
+		void link_connection(InstanceConnectionCPtr connection)
 		{
+			unlink_connection(connection);
+
+			// Only complete connections lead anywhere.
+			auto& items = connection->get().m_items;
+			if (items.size() == 2)
+			{
+				int index_a = m_snapshot.item_index(items[0]->get().m_schema_item);
+				int index_b = m_snapshot.item_index(items[1]->get().m_schema_item);
+
+				if (index_a != -1 && index_b != -1)
+				{
+					m_snapshot.add_connection(index_a, index_b);
+					m_connection_indices.insert(connection.get(), qMakePair(index_a, index_b));
+				}
+			}
+
+			m_dependency_graph.link_connection(connection);
+		}
+
+		void unlink_connection(InstanceConnectionCPtr connection)
+		{
+			auto it = m_connection_indices.find(connection.get());
+			if (it != m_connection_indices.end())
+			{
+				m_snapshot.remove_connection(it->first, it->second);
+				m_connection_indices.erase(it);
+			}
+
+			m_dependency_graph.unlink_connection(connection);
+		}
+
+		void link_item(int index, const InstanceItemData& data)
+		{
+			auto old_location = m_snapshot.m_items[index].m_location;
+			m_snapshot.set_item(index, data);
+
+			// Items sharing the old or new location are tied together differently now.
+			if (data.m_location != old_location)
+			{
+				for (auto location : { old_location, data.m_location })
+				{
+					if (location != nullptr)
+					{
+						m_dependency_graph.link_location(location.get(), m_snapshot.m_location_items.value(location.get()));
+					}
+				}
+			}
+		}
+
+		void invalidate_connection(InstanceConnectionCPtr connection)
+		{
+			for (auto item : connection->get().m_items)
+			{
+				m_dependency_graph.invalidate_item(item);
+			}
+		}
+
+		void record_progress_item(InstanceProgressItemCPtr progress_item)
+		{
+			forget_progress_item(progress_item);
+
+			int entity_id = get_entity_id(progress_item);
+
+			m_progress_state.add_item(entity_id);
+			m_progress_item_entities.insert(progress_item.get(), entity_id);
+
+			m_dependency_graph.invalidate_progress_item(m_data_model.get_entity_db().get_entity(entity_id));
+		}
+
+		void forget_progress_item(InstanceProgressItemCPtr progress_item)
+		{
+			if (m_progress_item_entities.contains(progress_item.get()))
+			{
+				int entity_id = m_progress_item_entities.take(progress_item.get());
+
+				m_progress_state.remove_item(entity_id);
+				m_dependency_graph.invalidate_progress_item(m_data_model.get_entity_db().get_entity(entity_id));
+			}
+		}
+
+		void record_progress_location(InstanceProgressLocationCPtr progress_location)
+		{
+			forget_progress_location(progress_location);
+
+			auto& data = progress_location->get();
+			int entity_id = get_entity_id(data);
+
+			m_progress_state.add_location(entity_id, data);
+			m_progress_location_data.insert(progress_location.get(), data);
+
+			m_dependency_graph.invalidate_progress_location(m_data_model.get_entity_db().get_entity(entity_id));
+		}
+
+		void forget_progress_location(InstanceProgressLocationCPtr progress_location)
+		{
+			if (m_progress_location_data.contains(progress_location.get()))
+			{
+				auto data = m_progress_location_data.take(progress_location.get());
+				int entity_id = get_entity_id(data);
+
+				m_progress_state.remove_location(entity_id, data);
+				m_dependency_graph.invalidate_progress_location(m_data_model.get_entity_db().get_entity(entity_id));
+			}
+		}
+
+		void mark_pending(const InstanceDirtySet& dirty_set)
+		{
+			for (auto region : dirty_set.m_regions)
+			{
+				int index = m_snapshot.region_index(region);
+				if (!m_pending_regions[index])
+				{
+					m_pending_regions[index] = true;
+					m_pending_region_indices << index;
+				}
+			}
+
+			for (auto item : dirty_set.m_items)
+			{
+				int index = m_snapshot.item_index(item->get().m_schema_item);
+				if (!m_pending_items[index])
+				{
+					m_pending_items[index] = true;
+					m_pending_item_indices << index;
+				}
+			}
+		}
+
+		void clear_pending()
+		{
+			for (int index : m_pending_region_indices)
+			{
+				m_pending_regions[index] = false;
+			}
+
+			for (int index : m_pending_item_indices)
+			{
+				m_pending_items[index] = false;
+			}
+
+			m_pending_region_indices.clear();
+			m_pending_item_indices.clear();
 		}
 	};
 
@@ -91,18 +283,53 @@ namespace LTTPMapTracker
 			m_internal->m_progress_locations.add(location);
 		}
 
+		auto& snapshot = m_internal->m_snapshot;
+		snapshot.m_schema = schema;
+		snapshot.m_regions = schema->regions().get();
+		snapshot.m_rules = schema->rules().get();
+
+		for (auto rule : snapshot.m_rules)
+		{
+			snapshot.m_programs << get_rule_program(*this, rule);
+		}
+
+		for (auto item : m_internal->m_items)
+		{
+			snapshot.m_items << item->get();
+		}
+
+		snapshot.index_schema();
+
+		m_internal->m_dependency_graph.build();
+		rebuild_adjacency();
+		rebuild_progress_state();
+
+		m_internal->m_region_accessible.fill(false, snapshot.m_regions.size());
+		m_internal->m_item_accessible.fill(false, m_internal->m_items.size());
+		m_internal->m_pending_regions.fill(false, snapshot.m_regions.size());
+		m_internal->m_pending_items.fill(false, m_internal->m_items.size());
+		m_internal->m_item_status.fill(InstanceItemStatus::Inaccessible, m_internal->m_items.size());
+
+		m_internal->m_dependency_graph.invalidate_all();
 		cache_accessibility();
 
 		// Signals.
-		connect(&m_internal->m_connections, &InstanceConnections::signal_added, this, &Instance::set_dirty);
-		connect(&m_internal->m_connections, &InstanceConnections::signal_removed, this, &Instance::set_dirty);
-		connect(&m_internal->m_connections, &InstanceConnections::signal_modified, this, &Instance::set_dirty);
-		connect(&m_internal->m_progress_items, &InstanceProgressItems::signal_added, this, &Instance::set_dirty);
-		connect(&m_internal->m_progress_items, &InstanceProgressItems::signal_removed, this, &Instance::set_dirty);
-		connect(&m_internal->m_progress_items, &InstanceProgressItems::signal_modified, this, &Instance::set_dirty);
-		connect(&m_internal->m_progress_locations, &InstanceProgressLocations::signal_added, this, &Instance::set_dirty);
-		connect(&m_internal->m_progress_locations, &InstanceProgressLocations::signal_removed, this, &Instance::set_dirty);
-		connect(&m_internal->m_progress_locations, &InstanceProgressLocations::signal_modified, this, &Instance::set_dirty);
+		connect(&m_internal->m_connections, &InstanceConnections::signal_added, this, &Instance::slot_connection_modified);
+		connect(&m_internal->m_connections, &InstanceConnections::signal_to_be_removed, this, &Instance::slot_connection_to_be_removed);
+		connect(&m_internal->m_connections, &InstanceConnections::signal_removed, this, &Instance::slot_connection_removed);
+		connect(&m_internal->m_connections, &InstanceConnections::signal_modified, this, &Instance::slot_connection_modified);
+		connect(&m_internal->m_connections, &InstanceConnections::signal_batch_changed, this, &Instance::slot_connections_batch_changed);
+		connect(&m_internal->m_progress_items, &InstanceProgressItems::signal_added, this, &Instance::slot_progress_item_modified);
+		connect(&m_internal->m_progress_items, &InstanceProgressItems::signal_to_be_removed, this, &Instance::slot_progress_item_to_be_removed);
+		connect(&m_internal->m_progress_items, &InstanceProgressItems::signal_removed, this, &Instance::slot_progress_removed);
+		connect(&m_internal->m_progress_items, &InstanceProgressItems::signal_modified, this, &Instance::slot_progress_item_modified);
+		connect(&m_internal->m_progress_items, &InstanceProgressItems::signal_batch_changed, this, &Instance::slot_progress_items_batch_changed);
+		connect(&m_internal->m_progress_locations, &InstanceProgressLocations::signal_added, this, &Instance::slot_progress_location_modified);
+		connect(&m_internal->m_progress_locations, &InstanceProgressLocations::signal_to_be_removed, this, &Instance::slot_progress_location_to_be_removed);
+		connect(&m_internal->m_progress_locations, &InstanceProgressLocations::signal_removed, this, &Instance::slot_progress_removed);
+		connect(&m_internal->m_progress_locations, &InstanceProgressLocations::signal_modified, this, &Instance::slot_progress_location_modified);
+		connect(&m_internal->m_progress_locations, &InstanceProgressLocations::signal_batch_changed, this, &Instance::slot_progress_locations_batch_changed);
+		connect(&m_internal->m_evaluator, &InstanceEvaluator::signal_evaluated, this, &Instance::slot_accessibility_evaluated);
 	}
 
 	Instance::~Instance()
@@ -213,6 +440,13 @@ namespace LTTPMapTracker
 		result << m_internal->m_progress_items.deserialise("ProgressItems", json, version, m_internal->m_data_model.get_item_db());
 		result << m_internal->m_progress_locations.deserialise("ProgressLocations", json, version, m_internal->m_data_model.get_location_db());
 		
+		rebuild_adjacency();
+		rebuild_progress_state();
+
+		m_internal->m_dependency_graph.invalidate_all();
+
+		// Deserialising doesn't signal, so report every item as changed.
+		m_internal->m_report_all_items = true;
 		cache_accessibility();
 
 		m_internal->m_filename = filename;
@@ -249,6 +483,37 @@ namespace LTTPMapTracker
 
 
 
+	//================================================================================
+	// Batching
+	//================================================================================
+
+	void Instance::begin_batch()
+	{
+		++m_internal->m_batch_depth;
+		m_internal->m_connections.begin_batch();
+		m_internal->m_progress_items.begin_batch();
+		m_internal->m_progress_locations.begin_batch();
+	}
+
+	void Instance::end_batch()
+	{
+		Q_ASSERT(m_internal->m_batch_depth > 0);
+
+		// The containers report their queued changes while the instance's batch is still
+		// open, so everything they invalidate goes into the one pass below.
+		m_internal->m_connections.end_batch();
+		m_internal->m_progress_items.end_batch();
+		m_internal->m_progress_locations.end_batch();
+
+		if (--m_internal->m_batch_depth == 0 && m_internal->m_batch_pending)
+		{
+			m_internal->m_batch_pending = false;
+			update_accessibility();
+		}
+	}
+
+
+
 	//================================================================================
 	// Data
 	//================================================================================
@@ -293,12 +558,70 @@ namespace LTTPMapTracker
 		return m_internal->m_progress_locations;
 	}
 
+	const InstanceProgressState& Instance::progress_state() const
+	{
+		return m_internal->m_progress_state;
+	}
+
+	quint64 Instance::progress_epoch() const
+	{
+		return m_internal->m_progress_state.get_epoch();
+	}
+
+
+
+	//================================================================================
+	// Accessibility
+	//================================================================================
+
+	bool Instance::is_accessible(InstanceItemCPtr item) const
+	{
+		int index = m_internal->m_snapshot.item_index(item->get().m_schema_item);
+		return (index != -1 && m_internal->m_item_accessible[index]);
+	}
+
+	bool Instance::is_accessible(SchemaRegionCPtr region) const
+	{
+		int index = m_internal->m_snapshot.region_index(region);
+		return (index != -1 && m_internal->m_region_accessible[index]);
+	}
+
+	InstanceItemStatus Instance::get_item_status(InstanceItemCPtr item) const
+	{
+		int index = m_internal->m_snapshot.item_index(item->get().m_schema_item);
+		return (index != -1 ? m_internal->m_item_status[index] : InstanceItemStatus::Inaccessible);
+	}
+
+	void Instance::recache_accessibility()
+	{
+		m_internal->m_dependency_graph.invalidate_all();
+		cache_accessibility();
+	}
+
+
+
+	//================================================================================
+	// Adjacency
+	//================================================================================
+
+	bool Instance::is_connected(InstanceItemCPtr item_a, InstanceItemCPtr item_b) const
+	{
+		int index_a = m_internal->m_snapshot.item_index(item_a->get().m_schema_item);
+		int index_b = m_internal->m_snapshot.item_index(item_b->get().m_schema_item);
+		return (index_a != -1 && index_b != -1 && m_internal->m_snapshot.m_item_neighbours[index_a].contains(index_b));
+	}
+
 
 
 	//================================================================================
 	// Accessors
 	//================================================================================
 
+	const DataModel& Instance::get_data_model() const
+	{
+		return m_internal->m_data_model;
+	}
+
 	SchemaCPtr Instance::get_schema() const
 	{
 		return m_internal->m_schema;
@@ -306,6 +629,156 @@ namespace LTTPMapTracker
 
 
 
+	//================================================================================
+	// Data Slots
+	//================================================================================
+
+	void Instance::slot_item_modified(InstanceItemCPtr item, DataFields fields)
+	{
+		int index = m_internal->m_snapshot.item_index(item->get().m_schema_item);
+		if (index != -1)
+		{
+			m_internal->link_item(index, item->get());
+		}
+
+		// Only the location feeds into accessibility. Required items don't affect reachability,
+		// but they do decide the item's status, which is published when the next pass is applied.
+		if (fields & (InstanceItemData::FieldSchemaItem | InstanceItemData::FieldLocation | InstanceItemData::FieldLocationEntrance))
+		{
+			m_internal->m_dependency_graph.invalidate_item(item);
+			update_accessibility();
+		}
+		else if (fields & InstanceItemData::FieldItems)
+		{
+			update_accessibility();
+		}
+		else
+		{
+			set_dirty();
+		}
+	}
+
+	void Instance::slot_connection_modified(int index)
+	{
+		auto connection = m_internal->m_connections.get()[index];
+		m_internal->link_connection(connection);
+		m_internal->invalidate_connection(connection);
+		update_accessibility();
+	}
+
+	void Instance::slot_connection_to_be_removed(int index)
+	{
+		auto connection = m_internal->m_connections.get()[index];
+		m_internal->unlink_connection(connection);
+		m_internal->invalidate_connection(connection);
+	}
+
+	void Instance::slot_connection_removed(int /*index*/)
+	{
+		update_accessibility();
+	}
+
+	void Instance::slot_connections_batch_changed()
+	{
+		auto& changes = m_internal->m_connections.get_batch_changes();
+
+		for (auto connection : changes.m_removed)
+		{
+			m_internal->unlink_connection(connection);
+			m_internal->invalidate_connection(connection);
+		}
+
+		for (auto connections : { &changes.m_added, &changes.m_modified })
+		{
+			for (auto connection : *connections)
+			{
+				m_internal->link_connection(connection);
+				m_internal->invalidate_connection(connection);
+			}
+		}
+
+		update_accessibility();
+	}
+
+	void Instance::slot_progress_item_modified(int index)
+	{
+		m_internal->record_progress_item(m_internal->m_progress_items.get()[index]);
+		update_accessibility();
+	}
+
+	void Instance::slot_progress_item_to_be_removed(int index)
+	{
+		m_internal->forget_progress_item(m_internal->m_progress_items.get()[index]);
+	}
+
+	void Instance::slot_progress_items_batch_changed()
+	{
+		auto& changes = m_internal->m_progress_items.get_batch_changes();
+
+		for (auto progress_item : changes.m_removed)
+		{
+			m_internal->forget_progress_item(progress_item);
+		}
+
+		for (auto progress_items : { &changes.m_added, &changes.m_modified })
+		{
+			for (auto progress_item : *progress_items)
+			{
+				m_internal->record_progress_item(progress_item);
+			}
+		}
+
+		update_accessibility();
+	}
+
+	void Instance::slot_progress_location_modified(int index)
+	{
+		m_internal->record_progress_location(m_internal->m_progress_locations.get()[index]);
+		update_accessibility();
+	}
+
+	void Instance::slot_progress_location_to_be_removed(int index)
+	{
+		m_internal->forget_progress_location(m_internal->m_progress_locations.get()[index]);
+	}
+
+	void Instance::slot_progress_locations_batch_changed()
+	{
+		auto& changes = m_internal->m_progress_locations.get_batch_changes();
+
+		for (auto progress_location : changes.m_removed)
+		{
+			m_internal->forget_progress_location(progress_location);
+		}
+
+		for (auto progress_locations : { &changes.m_added, &changes.m_modified })
+		{
+			for (auto progress_location : *progress_locations)
+			{
+				m_internal->record_progress_location(progress_location);
+			}
+		}
+
+		update_accessibility();
+	}
+
+	void Instance::slot_progress_removed(int /*index*/)
+	{
+		update_accessibility();
+	}
+
+	void Instance::slot_accessibility_evaluated(InstanceEvaluationPtr evaluation)
+	{
+		// A superseded pass is still shown, but its changes stay pending so the newer pass
+		// re-evaluates them; passes cut short by a synchronous recache are dropped.
+		if (!m_internal->m_evaluator.is_cancelled(*evaluation))
+		{
+			apply_evaluation(*evaluation, m_internal->m_evaluator.is_latest(*evaluation));
+		}
+	}
+
+
+
 	//================================================================================
 	// Helpers
 	//================================================================================
@@ -316,7 +789,10 @@ namespace LTTPMapTracker
 		auto data = item->get();
 		data.m_schema_item = schema_item;
 		item->set(data);
-		QObject::connect(item.get(), &InstanceItem::signal_modified, this, &Instance::set_dirty);
+
+		std::weak_ptr<const InstanceItem> weak_item = item;
+		QObject::connect(item.get(), &InstanceItem::signal_modified, this, [this, weak_item] (DataFields fields) { slot_item_modified(weak_item.lock(), fields); });
+
 		return item;
 	}
 
@@ -364,52 +840,207 @@ namespace LTTPMapTracker
 
 	//--------------------------------------------------------------------------------
 
+	void Instance::rebuild_adjacency()
+	{
+		auto& internal = *m_internal;
+
+		// Items are deserialised without signalling, so the snapshot takes a fresh copy.
+		for (int i = 0; i < internal.m_items.size(); ++i)
+		{
+			internal.m_snapshot.m_items[i] = internal.m_items[i]->get();
+		}
+
+		internal.m_snapshot.index_instance();
+		internal.m_snapshot.clear_connections();
+		internal.m_connection_indices.clear();
+		internal.m_dependency_graph.clear_instance_links();
+
+		auto& location_items = internal.m_snapshot.m_location_items;
+		for (auto it = location_items.begin(); it != location_items.end(); ++it)
+		{
+			internal.m_dependency_graph.link_location(it.key(), it.value());
+		}
+
+		for (auto connection : internal.m_connections.get())
+		{
+			internal.link_connection(connection);
+		}
+	}
+
+	void Instance::rebuild_progress_state()
+	{
+		m_internal->m_progress_state.reset(m_internal->m_data_model.get_entity_db().get_num_entities());
+		m_internal->m_progress_item_entities.clear();
+		m_internal->m_progress_location_data.clear();
+
+		for (auto progress_item : m_internal->m_progress_items.get())
+		{
+			int entity_id = get_entity_id(progress_item);
+			m_internal->m_progress_state.add_item(entity_id);
+			m_internal->m_progress_item_entities.insert(progress_item.get(), entity_id);
+		}
+
+		for (auto progress_location : m_internal->m_progress_locations.get())
+		{
+			m_internal->m_progress_state.add_location(get_entity_id(progress_location->get()), progress_location->get());
+			m_internal->m_progress_location_data.insert(progress_location.get(), progress_location->get());
+		}
+	}
+
 	void Instance::set_dirty()
 	{
-		cache_accessibility();
 		m_internal->m_dirty = true;
 		emit signal_dirty_state_changed(true);
 	}
 
-	void Instance::cache_accessibility()
+	void Instance::update_accessibility()
 	{
-		// Schema regions.
-		for (auto region : m_internal->m_schema->regions().get())
+		// Inside a batch the dependency graph keeps collecting invalid nodes; one pass runs when it ends.
+		if (m_internal->m_batch_depth > 0)
 		{
-			region->get().m_accessible_cached = false;
+			m_internal->m_batch_pending = true;
+			return;
 		}
 
-		for (auto region : m_internal->m_schema->regions().get())
+		m_internal->m_evaluator.submit(create_snapshot());
+		set_dirty();
+	}
+
+	void Instance::cache_accessibility()
+	{
+		// Synchronous pass, used where the result is needed straight away (construction, loading).
+		m_internal->m_evaluator.cancel();
+
+		InstanceEvaluation evaluation(create_snapshot(), 0);
+		evaluate_accessibility(evaluation, [] () { return false; });
+		apply_evaluation(evaluation, true);
+	}
+
+	InstanceSnapshotCPtr Instance::create_snapshot()
+	{
+		auto& internal = *m_internal;
+
+		// Only nodes downstream of a change are re-evaluated; everything else keeps its last applied result.
+		internal.mark_pending(internal.m_dependency_graph.take_invalid());
+
+		// A shallow copy; edits made while the pass runs detach only the tables they touch.
+		auto snapshot = std::make_shared<InstanceSnapshot>(internal.m_snapshot);
+		snapshot->m_progress_state = internal.m_progress_state;
+		snapshot->m_region_accessible = internal.m_region_accessible;
+		snapshot->m_item_accessible = internal.m_item_accessible;
+		snapshot->m_dirty_regions = internal.m_pending_region_indices;
+		snapshot->m_dirty_items = internal.m_pending_item_indices;
+
+		return snapshot;
+	}
+
+	void Instance::apply_evaluation(const InstanceEvaluation& evaluation, bool latest)
+	{
+		auto& internal = *m_internal;
+		auto& snapshot = *evaluation.m_snapshot;
+
+		// The latest pass publishes everything. A superseded pass only publishes the nodes it
+		// evaluated; the rest of its snapshot is older than what's already shown, and its
+		// changes stay pending so the newer pass evaluates them again.
+		QVector<int> all_regions;
+		QVector<int> all_items;
+
+		if (latest)
 		{
-			if (region->get().m_name == "DW - Main - West")
+			all_regions.reserve(internal.m_region_accessible.size());
+			all_items.reserve(internal.m_item_accessible.size());
+
+			for (int i = 0; i < internal.m_region_accessible.size(); ++i)
 			{
-				int a = 0;
-				++a;
+				all_regions << i;
 			}
 
-			region->get().m_accessible = match_rule(*this, region);
-			region->get().m_accessible_cached = true;
+			for (int i = 0; i < internal.m_item_accessible.size(); ++i)
+			{
+				all_items << i;
+			}
 		}
 
-		// Instance items.
-		for (auto item : m_internal->m_items)
+		auto& regions = (latest ? all_regions : snapshot.m_dirty_regions);
+		auto& items = (latest ? all_items : snapshot.m_dirty_items);
+
+		SchemaRegionCList changed_regions;
+		for (int i : regions)
 		{
-			item->get().m_accessible_cached = false;
+			if (evaluation.m_region_accessible[i] != internal.m_region_accessible[i])
+			{
+				internal.m_region_accessible[i] = evaluation.m_region_accessible[i];
+				changed_regions << snapshot.m_regions[i];
+			}
 		}
 
-		for (auto item : m_internal->m_items)
+		// Items are reported when anything that decides how they're shown has changed, which
+		// includes progress as well as accessibility. Statuses are taken from the same snapshot
+		// the pass evaluated, never from newer instance data.
+		QHash<const Location*, LocationMatch> location_matches;
+
+		InstanceItemCList changed_items;
+		for (int i : items)
 		{
-			if (item->get().m_schema_item->get().m_name == "Village of Outcasts - Chest Game")
+			internal.m_item_accessible[i] = evaluation.m_item_accessible[i];
+
+			auto status = evaluate_item_status(snapshot, i, location_matches);
+			if (status != internal.m_item_status[i] || internal.m_report_all_items)
 			{
-				int a = 0;
-				++a;
+				internal.m_item_status[i] = status;
+				changed_items << internal.m_items[i];
 			}
+		}
+
+		if (latest)
+		{
+			internal.clear_pending();
+			internal.m_report_all_items = false;
+		}
+
+		if (!changed_items.isEmpty() || !changed_regions.isEmpty())
+		{
+			emit signal_accessibility_changed(changed_items, changed_regions);
+		}
+	}
+
+	InstanceItemStatus Instance::evaluate_item_status(const InstanceSnapshot& snapshot, int item_index, QHash<const Location*, LocationMatch>& location_matches) const
+	{
+		if (!m_internal->m_item_accessible[item_index])
+		{
+			return InstanceItemStatus::Inaccessible;
+		}
+
+		auto& data = snapshot.m_items[item_index];
+		auto& progress_state = snapshot.m_progress_state;
+
+		bool requires_items = std::any_of(data.m_items.begin(), data.m_items.end(), [&progress_state] (ItemCPtr item)
+		{
+			return (item->m_entity == nullptr || !progress_state.has_item(item->m_entity->m_id));
+		});
 
+		if (requires_items)
+		{
+			return InstanceItemStatus::ItemRequirement;
+		}
 
-			item->get().m_accessible = match_rule(*this, item);
-			item->get().m_accessible_cached = true;
+		if (data.m_location != nullptr)
+		{
+			// Many items share a location; its requirements are matched once per pass.
+			auto it = location_matches.find(data.m_location.get());
+			if (it == location_matches.end())
+			{
+				it = location_matches.insert(data.m_location.get(), match_location_requirements(data.m_location->m_requirements, progress_state));
+			}
+
+			switch (*it)
+			{
+			case LocationMatch::No: return InstanceItemStatus::LocationRequirement;
+			case LocationMatch::Maybe: return InstanceItemStatus::Location;
+			case LocationMatch::Yes: return InstanceItemStatus::LocationRequirementFulfilled;
+			}
 		}
 
-		emit signal_accessibility_cached();
+		return (data.m_items.isEmpty() ? InstanceItemStatus::Accessible : InstanceItemStatus::ItemRequirementFulfilled);
 	}
 }
\ No newline at end of file
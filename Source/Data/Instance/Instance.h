@@ -3,6 +3,8 @@
 
 // Project includes
 #include "Data/Instance/InstanceData.h"
+#include "Data/Instance/InstanceProgressState.h"
+#include "Data/Instance/InstanceSnapshot.h"
 #include "Utility/DataContainer.h"
 #include "EditorTypeInfo.h"
 
@@ -18,6 +20,20 @@ namespace LTTPMapTracker
 	using InstanceConnections = SearchableDataContainer<InstanceConnection, InstanceItemPtr, QVector<InstanceItemPtr>>;
 	using InstanceProgressItems = SearchableDataContainer<InstanceProgressItem, EntityCPtr, ItemCPtr>;
 	using InstanceProgressLocations = SearchableDataContainer<InstanceProgressLocation, EntityCPtr, LocationCPtr>;
+	using InstanceItemCList = QVector<InstanceItemCPtr>;
+	using SchemaRegionCList = QVector<SchemaRegionCPtr>;
+
+	// How an item is shown on the map, in the order markers pick their color.
+	enum class InstanceItemStatus
+	{
+		Inaccessible,
+		Accessible,
+		ItemRequirement,
+		ItemRequirementFulfilled,
+		LocationRequirement,
+		Location,
+		LocationRequirementFulfilled
+	};
 
 
 	// Instance
@@ -29,53 +45,92 @@ namespace LTTPMapTracker
 
 	public:
 		// Construction & Destruction
-											Instance						(const DataModel& data_model, SchemaCPtr schema);
-											~Instance						();
+											Instance								(const DataModel& data_model, SchemaCPtr schema);
+											~Instance								();
 
 		// Save & Load
-		Result								save							();
-		Result								save							(QString filename);
-		Result								save_auto						();
-		Result								load							(QString filename);
-		Result								load_template					(QString filename);
+		Result								save									();
+		Result								save									(QString filename);
+		Result								save_auto								();
+		Result								load									(QString filename);
+		Result								load_template							(QString filename);
 
 		// Properties
-		QString								get_filename					();
-		bool								is_dirty						() const;
+		QString								get_filename							();
+		bool								is_dirty								() const;
+
+		// Batching
+		void								begin_batch								();
+		void								end_batch								();
 
 		// Data
-		const QVector<InstanceItemPtr>&		items							();
-		const QVector<InstanceItemCPtr>&	items							() const;
+		const QVector<InstanceItemPtr>&		items									();
+		const QVector<InstanceItemCPtr>&	items									() const;
+
+		InstanceConnections&				connections								();
+		const InstanceConnections&			connections								() const;
+
+		InstanceProgressItems&				progress_items							();
+		const InstanceProgressItems&		progress_items							() const;
+
+		InstanceProgressLocations&			progress_locations						();
+		const InstanceProgressLocations&	progress_locations						() const;
 
-		InstanceConnections&				connections						();
-		const InstanceConnections&			connections						() const;
+		const InstanceProgressState&		progress_state							() const;
+		quint64								progress_epoch							() const;
 
-		InstanceProgressItems&				progress_items					();
-		const InstanceProgressItems&		progress_items					() const;
+		// Accessibility
+		bool								is_accessible							(InstanceItemCPtr item) const;
+		bool								is_accessible							(SchemaRegionCPtr region) const;
+		InstanceItemStatus					get_item_status							(InstanceItemCPtr item) const;
+		void								recache_accessibility					();
 
-		InstanceProgressLocations&			progress_locations				();
-		const InstanceProgressLocations&	progress_locations				() const;
+		// Adjacency
+		bool								is_connected							(InstanceItemCPtr item_a, InstanceItemCPtr item_b) const;
 
 		// Accessors
-		SchemaCPtr							get_schema						() const;
+		const DataModel&					get_data_model							() const;
+		SchemaCPtr							get_schema								() const;
 
 	signals:
 		// Signals
-		void								signal_dirty_state_changed		(bool dirty);
-		void								signal_accessibility_cached		();
+		void								signal_dirty_state_changed				(bool dirty);
+		void								signal_accessibility_changed			(const InstanceItemCList& items, const SchemaRegionCList& regions);
+
+	private slots:
+		// Data Slots
+		void								slot_item_modified						(InstanceItemCPtr item, DataFields fields);
+		void								slot_connection_modified				(int index);
+		void								slot_connection_to_be_removed			(int index);
+		void								slot_connection_removed					(int index);
+		void								slot_connections_batch_changed			();
+		void								slot_progress_item_modified				(int index);
+		void								slot_progress_item_to_be_removed		(int index);
+		void								slot_progress_items_batch_changed		();
+		void								slot_progress_location_modified			(int index);
+		void								slot_progress_location_to_be_removed	(int index);
+		void								slot_progress_locations_batch_changed	();
+		void								slot_progress_removed					(int index);
+		void								slot_accessibility_evaluated			(InstanceEvaluationPtr evaluation);
 
 	private:
 		// Helpers
-		InstanceItemPtr						create_item						(SchemaItemCPtr schema_item);
-		InstanceConnectionPtr				create_connection_empty			();
-		InstanceConnectionPtr				create_connection				(QVector<InstanceItemPtr> instance_items);
-		InstanceProgressItemPtr				create_progress_item_empty		();
-		InstanceProgressItemPtr				create_progress_item			(ItemCPtr item);
-		InstanceProgressLocationPtr			create_progress_location_empty	();
-		InstanceProgressLocationPtr			create_progress_location		(LocationCPtr location);
-
-		void								set_dirty						();
-		void								cache_accessibility				();
+		InstanceItemPtr						create_item								(SchemaItemCPtr schema_item);
+		InstanceConnectionPtr				create_connection_empty					();
+		InstanceConnectionPtr				create_connection						(QVector<InstanceItemPtr> instance_items);
+		InstanceProgressItemPtr				create_progress_item_empty				();
+		InstanceProgressItemPtr				create_progress_item					(ItemCPtr item);
+		InstanceProgressLocationPtr			create_progress_location_empty			();
+		InstanceProgressLocationPtr			create_progress_location				(LocationCPtr location);
+
+		void								rebuild_adjacency						();
+		void								rebuild_progress_state					();
+		void								set_dirty								();
+		void								update_accessibility					();
+		void								cache_accessibility						();
+		InstanceSnapshotCPtr				create_snapshot							();
+		void								apply_evaluation						(const InstanceEvaluation& evaluation, bool latest);
+		InstanceItemStatus					evaluate_item_status					(const InstanceSnapshot& snapshot, int item_index, QHash<const Location*, LocationMatch>& location_matches) const;
 
 		struct Internal;
 		const std::unique_ptr<Internal> m_internal;
@@ -18,8 +18,6 @@ namespace LTTPMapTracker
 
 	InstanceItemData::InstanceItemData()
 		: m_cleared(false)
-		, m_accessible(false)
-		, m_accessible_cached(false)
 	{
 	}
 
@@ -80,6 +78,17 @@ namespace LTTPMapTracker
 		return result;
 	}
 
+	DataFields get_changed_fields(const InstanceItemData& before, const InstanceItemData& after)
+	{
+		DataFields fields = 0;
+		fields |= (before.m_schema_item != after.m_schema_item ? InstanceItemData::FieldSchemaItem : 0);
+		fields |= (before.m_items != after.m_items ? InstanceItemData::FieldItems : 0);
+		fields |= (before.m_location != after.m_location ? InstanceItemData::FieldLocation : 0);
+		fields |= (before.m_location_entrance != after.m_location_entrance ? InstanceItemData::FieldLocationEntrance : 0);
+		fields |= (before.m_cleared != after.m_cleared ? InstanceItemData::FieldCleared : 0);
+		return fields;
+	}
+
 
 
 	//================================================================================
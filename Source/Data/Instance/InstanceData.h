@@ -17,20 +17,28 @@ namespace LTTPMapTracker
 
 	struct InstanceItemData
 	{
+		enum Field
+		{
+			FieldSchemaItem			= 1 << 0,
+			FieldItems				= 1 << 1,
+			FieldLocation			= 1 << 2,
+			FieldLocationEntrance	= 1 << 3,
+			FieldCleared			= 1 << 4
+		};
+
 		SchemaItemCPtr		m_schema_item;
 		QVector<ItemCPtr>	m_items;
 		LocationCPtr		m_location;
 		EntityCPtr			m_location_entrance;
 		bool				m_cleared;
 
-		mutable bool		m_accessible;
-		mutable bool		m_accessible_cached;
-
 				InstanceItemData	();
 		void	serialise			(QJsonObject& json) const;
 		Result	deserialise			(const QJsonObject& json, int version, const EntityDatabase& entity_db, const ItemDatabase& item_db, const LocationDatabase& location_db);
 	};
 
+	DataFields get_changed_fields(const InstanceItemData& before, const InstanceItemData& after);
+
 	class InstanceItem : public SerializableDataWrapper<InstanceItemData> {};
 
 
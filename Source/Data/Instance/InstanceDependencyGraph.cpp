@@ -0,0 +1,515 @@
+// Project includes
+#include "Data/Instance/InstanceDependencyGraph.h"
+#include "Data/Instance/Instance.h"
+#include "Data/Instance/InstanceRuleParser.h"
+#include "Data/Schema/Schema.h"
+#include "Data/Schema/SchemaRuleProgram.h"
+
+
+namespace LTTPMapTracker
+{
+	//================================================================================
+	// Internal
+	//================================================================================
+
+	struct InstanceDependencyGraph::Internal
+	{
+		struct Links
+		{
+			QVector<QVector<int>>			m_dependents;
+			QHash<int, QVector<int>>		m_progress_items;
+			QHash<int, QVector<int>>		m_progress_locations;
+			QVector<int>					m_progress_specials;
+
+			void clear(int num_nodes)
+			{
+				m_dependents.clear();
+				m_dependents.resize(num_nodes);
+				m_progress_items.clear();
+				m_progress_locations.clear();
+				m_progress_specials.clear();
+			}
+		};
+
+		// Instance links contributed by one connection or location, so they can be taken back out.
+		struct Source
+		{
+			QVector<QPair<int, int>>		m_links;
+			QVector<QPair<int, int>>		m_progress_items;
+			QVector<QPair<int, int>>		m_progress_locations;
+			QVector<int>					m_progress_specials;
+		};
+
+		const Instance&					m_instance;
+
+		QVector<SchemaRegionCPtr>		m_regions;
+		QVector<InstanceItemCPtr>		m_items;
+		QHash<const SchemaRegion*, int>	m_region_nodes;
+		QHash<const SchemaItem*, int>	m_schema_item_nodes;
+		QHash<const InstanceItem*, int>	m_item_nodes;
+
+		Links							m_schema_links;
+		Links							m_instance_links;
+
+		QHash<const InstanceConnection*, Source>	m_connection_sources;
+		QHash<const Location*, Source>				m_location_sources;
+
+		QVector<bool>					m_invalid;
+		QVector<int>					m_invalid_nodes;
+
+		Internal(const Instance& instance)
+			: m_instance(instance)
+		{
+		}
+
+		int num_nodes() const
+		{
+			return (m_regions.size() + m_items.size());
+		}
+
+		int region_node(SchemaRegionCPtr region) const
+		{
+			return (region != nullptr ? m_region_nodes.value(region.get(), -1) : -1);
+		}
+
+		int item_node(InstanceItemCPtr item) const
+		{
+			return (item != nullptr ? m_item_nodes.value(item.get(), -1) : -1);
+		}
+
+		int item_region_node(InstanceItemCPtr item) const
+		{
+			return region_node(item->get().m_schema_item->get().m_region);
+		}
+
+		int item_index_node(int item_index) const
+		{
+			return (m_regions.size() + item_index);
+		}
+
+		void add_link(Links& links, int node, int dependent)
+		{
+			if (node != -1 && dependent != -1 && node != dependent && !links.m_dependents[node].contains(dependent))
+			{
+				links.m_dependents[node] << dependent;
+			}
+		}
+
+		void add_rule_links(Links& links, SchemaRuleCPtr rule, int dependent, QVector<SchemaRuleCPtr>& visited)
+		{
+			if (rule == nullptr || visited.contains(rule))
+			{
+				return;
+			}
+
+			visited << rule;
+
+			for (auto& entry : get_rule_program(m_instance, rule)->m_entries)
+			{
+				switch (entry.m_type)
+				{
+				case SchemaRuleType::ProgressItem:
+					links.m_progress_items[entry.m_entity] << dependent;
+					break;
+
+				case SchemaRuleType::ProgressLocation:
+					links.m_progress_locations[entry.m_entity] << dependent;
+					break;
+
+				case SchemaRuleType::ProgressSpecial:
+					links.m_progress_specials << dependent;
+					break;
+
+				case SchemaRuleType::SchemaRule:
+					add_rule_links(links, entry.m_rule.lock(), dependent, visited);
+					break;
+
+				case SchemaRuleType::SchemaItem:
+					{
+						auto schema_item = entry.m_item.lock();
+						if (schema_item != nullptr)
+						{
+							add_link(links, m_schema_item_nodes.value(schema_item.get(), -1), dependent);
+						}
+					}
+					break;
+
+				case SchemaRuleType::SchemaRegion:
+					add_link(links, region_node(entry.m_region.lock()), dependent);
+					break;
+
+				case SchemaRuleType::Inaccessible:
+					break;
+				}
+			}
+		}
+
+		void add_rule_links(Links& links, SchemaRuleCPtr rule, int dependent)
+		{
+			QVector<SchemaRuleCPtr> visited;
+			add_rule_links(links, rule, dependent, visited);
+		}
+
+		void record_link(Source& source, int node, int dependent)
+		{
+			auto link = qMakePair(node, dependent);
+
+			if (node != -1 && dependent != -1 && node != dependent && !source.m_links.contains(link))
+			{
+				source.m_links << link;
+			}
+		}
+
+		void record_requirements(Source& source, const QVector<LocationRequirement>& requirements, int dependent)
+		{
+			for (auto& requirement : requirements)
+			{
+				for (auto& entry : requirement.m_entries)
+				{
+					switch (entry.m_type)
+					{
+					case LocationRequirementType::ProgressItem: source.m_progress_items << qMakePair(entry.m_id, dependent); break;
+					case LocationRequirementType::ProgressLocation: source.m_progress_locations << qMakePair(entry.m_id, dependent); break;
+					case LocationRequirementType::ProgressSpecial: source.m_progress_specials << dependent; break;
+					}
+				}
+			}
+		}
+
+		void add_source(const Source& source)
+		{
+			// Instance links may repeat across sources; each copy is removed with its source.
+			for (auto& link : source.m_links)
+			{
+				m_instance_links.m_dependents[link.first] << link.second;
+
+				// Anything already invalid now reaches the new dependent too.
+				if (m_invalid[link.first])
+				{
+					invalidate(link.second);
+				}
+			}
+
+			for (auto& link : source.m_progress_items)
+			{
+				m_instance_links.m_progress_items[link.first] << link.second;
+			}
+
+			for (auto& link : source.m_progress_locations)
+			{
+				m_instance_links.m_progress_locations[link.first] << link.second;
+			}
+
+			m_instance_links.m_progress_specials << source.m_progress_specials;
+		}
+
+		void remove_source(const Source& source)
+		{
+			for (auto& link : source.m_links)
+			{
+				m_instance_links.m_dependents[link.first].removeOne(link.second);
+			}
+
+			for (auto& link : source.m_progress_items)
+			{
+				m_instance_links.m_progress_items[link.first].removeOne(link.second);
+			}
+
+			for (auto& link : source.m_progress_locations)
+			{
+				m_instance_links.m_progress_locations[link.first].removeOne(link.second);
+			}
+
+			for (int dependent : source.m_progress_specials)
+			{
+				m_instance_links.m_progress_specials.removeOne(dependent);
+			}
+		}
+
+		void invalidate(int node)
+		{
+			if (node != -1 && !m_invalid[node])
+			{
+				m_invalid[node] = true;
+				m_invalid_nodes << node;
+				propagate(node);
+			}
+		}
+
+		void invalidate(const QVector<int>& nodes)
+		{
+			for (int node : nodes)
+			{
+				invalidate(node);
+			}
+		}
+
+		void propagate(int node)
+		{
+			QVector<int> pending;
+			pending << node;
+
+			while (!pending.isEmpty())
+			{
+				int current = pending.takeLast();
+
+				for (auto links : { &m_schema_links, &m_instance_links })
+				{
+					for (int dependent : links->m_dependents[current])
+					{
+						if (!m_invalid[dependent])
+						{
+							m_invalid[dependent] = true;
+							m_invalid_nodes << dependent;
+							pending << dependent;
+						}
+					}
+				}
+			}
+		}
+	};
+
+
+
+	//================================================================================
+	// Construction & Destruction
+	//================================================================================
+
+	InstanceDependencyGraph::InstanceDependencyGraph(const Instance& instance)
+		: m_internal(std::make_unique<Internal>(instance))
+	{
+	}
+
+	InstanceDependencyGraph::~InstanceDependencyGraph()
+	{
+	}
+
+
+
+	//================================================================================
+	// Building
+	//================================================================================
+
+	void InstanceDependencyGraph::build()
+	{
+		auto& internal = *m_internal;
+
+		// Nodes.
+		internal.m_regions = internal.m_instance.get_schema()->regions().get();
+		internal.m_items = internal.m_instance.items();
+		internal.m_region_nodes.clear();
+		internal.m_schema_item_nodes.clear();
+		internal.m_item_nodes.clear();
+
+		for (int i = 0; i < internal.m_regions.size(); ++i)
+		{
+			internal.m_region_nodes.insert(internal.m_regions[i].get(), i);
+		}
+
+		for (int i = 0; i < internal.m_items.size(); ++i)
+		{
+			int node = internal.m_regions.size() + i;
+			internal.m_item_nodes.insert(internal.m_items[i].get(), node);
+			internal.m_schema_item_nodes.insert(internal.m_items[i]->get().m_schema_item.get(), node);
+		}
+
+		internal.m_invalid.fill(false, internal.num_nodes());
+		internal.m_invalid_nodes.clear();
+
+		// Schema links.
+		internal.m_schema_links.clear(internal.num_nodes());
+
+		for (auto region : internal.m_regions)
+		{
+			internal.add_rule_links(internal.m_schema_links, region->get().m_rule, internal.region_node(region));
+		}
+
+		for (auto item : internal.m_items)
+		{
+			auto& schema_item_data = item->get().m_schema_item->get();
+			int node = internal.item_node(item);
+			int region_node = internal.region_node(schema_item_data.m_region);
+
+			internal.add_link(internal.m_schema_links, region_node, node);
+			internal.add_rule_links(internal.m_schema_links, schema_item_data.m_rule, node);
+
+			// Regions check the rules of their own items when crossing connections and start positions.
+			if (region_node != -1)
+			{
+				internal.add_rule_links(internal.m_schema_links, schema_item_data.m_rule, region_node);
+			}
+		}
+
+		clear_instance_links();
+	}
+
+	void InstanceDependencyGraph::clear_instance_links()
+	{
+		m_internal->m_instance_links.clear(m_internal->num_nodes());
+		m_internal->m_connection_sources.clear();
+		m_internal->m_location_sources.clear();
+	}
+
+	void InstanceDependencyGraph::link_connection(InstanceConnectionCPtr connection)
+	{
+		auto& internal = *m_internal;
+
+		unlink_connection(connection);
+
+		auto& items = connection->get().m_items;
+		if (items.size() != 2)
+		{
+			return;
+		}
+
+		int node_a = internal.item_node(items[0]);
+		int node_b = internal.item_node(items[1]);
+
+		Internal::Source source;
+		internal.record_link(source, node_a, node_b);
+		internal.record_link(source, node_b, node_a);
+		internal.record_link(source, node_a, internal.item_region_node(items[1]));
+		internal.record_link(source, node_b, internal.item_region_node(items[0]));
+
+		internal.add_source(source);
+		internal.m_connection_sources.insert(connection.get(), source);
+	}
+
+	void InstanceDependencyGraph::unlink_connection(InstanceConnectionCPtr connection)
+	{
+		auto it = m_internal->m_connection_sources.find(connection.get());
+		if (it != m_internal->m_connection_sources.end())
+		{
+			m_internal->remove_source(*it);
+			m_internal->m_connection_sources.erase(it);
+		}
+	}
+
+	void InstanceDependencyGraph::link_location(const Location* location, const QVector<int>& item_indices)
+	{
+		auto& internal = *m_internal;
+
+		auto it = internal.m_location_sources.find(location);
+		if (it != internal.m_location_sources.end())
+		{
+			internal.remove_source(*it);
+			internal.m_location_sources.erase(it);
+		}
+
+		// Only locations that lead somewhere tie their items together.
+		if (location == nullptr || item_indices.size() < 2 || (location->m_entrances.isEmpty() && location->m_connections.isEmpty()))
+		{
+			return;
+		}
+
+		Internal::Source source;
+
+		for (int item_index : item_indices)
+		{
+			int node = internal.item_index_node(item_index);
+			int region_node = internal.item_region_node(internal.m_items[item_index]);
+
+			for (auto& connection : location->m_connections)
+			{
+				internal.record_requirements(source, connection.m_requirements, region_node);
+			}
+
+			for (int other_index : item_indices)
+			{
+				if (other_index != item_index)
+				{
+					int other_node = internal.item_index_node(other_index);
+					internal.record_link(source, other_node, node);
+					internal.record_link(source, other_node, region_node);
+					internal.record_link(source, internal.item_region_node(internal.m_items[other_index]), region_node);
+				}
+			}
+		}
+
+		internal.add_source(source);
+		internal.m_location_sources.insert(location, source);
+	}
+
+
+
+	//================================================================================
+	// Invalidation
+	//================================================================================
+
+	void InstanceDependencyGraph::invalidate_all()
+	{
+		for (int node = 0; node < m_internal->num_nodes(); ++node)
+		{
+			if (!m_internal->m_invalid[node])
+			{
+				m_internal->m_invalid[node] = true;
+				m_internal->m_invalid_nodes << node;
+			}
+		}
+	}
+
+	void InstanceDependencyGraph::invalidate_progress_item(EntityCPtr entity)
+	{
+		if (entity != nullptr)
+		{
+			m_internal->invalidate(m_internal->m_schema_links.m_progress_items.value(entity->m_id));
+			m_internal->invalidate(m_internal->m_instance_links.m_progress_items.value(entity->m_id));
+		}
+	}
+
+	void InstanceDependencyGraph::invalidate_progress_location(EntityCPtr entity)
+	{
+		if (entity != nullptr)
+		{
+			m_internal->invalidate(m_internal->m_schema_links.m_progress_locations.value(entity->m_id));
+			m_internal->invalidate(m_internal->m_instance_links.m_progress_locations.value(entity->m_id));
+		}
+
+		// Pendants and crystals are counted over every progress location.
+		m_internal->invalidate(m_internal->m_schema_links.m_progress_specials);
+		m_internal->invalidate(m_internal->m_instance_links.m_progress_specials);
+	}
+
+	void InstanceDependencyGraph::invalidate_region(SchemaRegionCPtr region)
+	{
+		m_internal->invalidate(m_internal->region_node(region));
+	}
+
+	void InstanceDependencyGraph::invalidate_item(InstanceItemCPtr item)
+	{
+		m_internal->invalidate(m_internal->item_node(item));
+		m_internal->invalidate(m_internal->item_region_node(item));
+	}
+
+	bool InstanceDependencyGraph::has_invalid() const
+	{
+		return !m_internal->m_invalid_nodes.isEmpty();
+	}
+
+	InstanceDirtySet InstanceDependencyGraph::take_invalid()
+	{
+		auto& internal = *m_internal;
+
+		InstanceDirtySet dirty_set;
+
+		std::sort(internal.m_invalid_nodes.begin(), internal.m_invalid_nodes.end());
+
+		for (int node : internal.m_invalid_nodes)
+		{
+			if (node < internal.m_regions.size())
+			{
+				dirty_set.m_regions << internal.m_regions[node];
+			}
+			else
+			{
+				dirty_set.m_items << internal.m_items[node - internal.m_regions.size()];
+			}
+
+			internal.m_invalid[node] = false;
+		}
+
+		internal.m_invalid_nodes.clear();
+
+		return dirty_set;
+	}
+}
\ No newline at end of file
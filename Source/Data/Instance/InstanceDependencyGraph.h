@@ -0,0 +1,70 @@
+#ifndef INSTANCE_DEPENDENCY_GRAPH_H
+#define INSTANCE_DEPENDENCY_GRAPH_H
+
+// Project includes
+#include "Data/Database/EntityDatabase.h"
+#include "Data/Database/LocationDatabase.h"
+#include "Data/Instance/InstanceTypeInfo.h"
+#include "Data/Schema/SchemaTypeInfo.h"
+
+// Qt includes
+#include <QHash>
+#include <QVector>
+
+// Stdlib includes
+#include <memory>
+
+
+namespace LTTPMapTracker
+{
+	// Types
+	//--------------------------------------------------------------------------------
+
+	struct InstanceDirtySet
+	{
+		QVector<SchemaRegionCPtr> m_regions;
+		QVector<InstanceItemCPtr> m_items;
+	};
+
+
+	// Instance Dependency Graph
+	//--------------------------------------------------------------------------------
+
+	// Tracks which schema regions and instance items read which pieces of instance state,
+	// so that a change only invalidates the nodes downstream of it.
+	// Schema links (rules, regions) are built once. Instance links are filed under the
+	// connection or shared location they come from and replaced one source at a time, so
+	// a connection or item location change only touches its own links. Items are given by
+	// their index in the instance.
+
+	class InstanceDependencyGraph
+	{
+	public:
+		// Construction & Destruction
+							InstanceDependencyGraph			(const Instance& instance);
+							~InstanceDependencyGraph		();
+
+		// Building
+		void				build							();
+		void				clear_instance_links			();
+		void				link_connection					(InstanceConnectionCPtr connection);
+		void				unlink_connection				(InstanceConnectionCPtr connection);
+		void				link_location					(const Location* location, const QVector<int>& item_indices);
+
+		// Invalidation
+		void				invalidate_all					();
+		void				invalidate_progress_item		(EntityCPtr entity);
+		void				invalidate_progress_location	(EntityCPtr entity);
+		void				invalidate_region				(SchemaRegionCPtr region);
+		void				invalidate_item					(InstanceItemCPtr item);
+
+		bool				has_invalid						() const;
+		InstanceDirtySet	take_invalid					();
+
+	private:
+		struct Internal;
+		const std::unique_ptr<Internal> m_internal;
+	};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,118 @@
+// Project includes
+#include "Data/Instance/InstanceEvaluator.h"
+#include "Data/Instance/InstanceRuleParser.h"
+
+// Qt includes
+#include <QElapsedTimer>
+#include <QThread>
+
+// Stdlib includes
+#include <atomic>
+
+
+namespace LTTPMapTracker
+{
+	//================================================================================
+	// Constants
+	//================================================================================
+
+	// Once nothing has been reported for this long, superseded passes are let through so
+	// continuous input still shows progress.
+	static const qint64 s_max_report_interval = 100;
+
+
+
+	//================================================================================
+	// Internal
+	//================================================================================
+
+	struct InstanceEvaluator::Internal
+	{
+		QThread					m_thread;
+		QObject					m_worker;
+		QElapsedTimer			m_clock;
+		std::atomic<int>		m_generation;
+		std::atomic<int>		m_cancelled_generation;
+		std::atomic<qint64>		m_last_reported;
+
+		Internal()
+			: m_generation(0)
+			, m_cancelled_generation(0)
+			, m_last_reported(0)
+		{
+			m_clock.start();
+		}
+
+		bool is_overdue() const
+		{
+			return (m_clock.elapsed() - m_last_reported.load() >= s_max_report_interval);
+		}
+	};
+
+
+
+	//================================================================================
+	// Construction & Destruction
+	//================================================================================
+
+	InstanceEvaluator::InstanceEvaluator()
+		: QObject(nullptr)
+		, m_internal(std::make_unique<Internal>())
+	{
+		qRegisterMetaType<InstanceEvaluationPtr>();
+
+		m_internal->m_worker.moveToThread(&m_internal->m_thread);
+
+		// Runs on the worker thread; the result is queued back to whoever listens on the GUI thread.
+		connect(this, &InstanceEvaluator::signal_submitted, &m_internal->m_worker, [this] (InstanceEvaluationPtr evaluation)
+		{
+			auto should_stop = [this, evaluation] ()
+			{
+				return (is_cancelled(*evaluation) || (!is_latest(*evaluation) && !m_internal->is_overdue()));
+			};
+
+			if (!should_stop() && evaluate_accessibility(*evaluation, should_stop))
+			{
+				m_internal->m_last_reported = m_internal->m_clock.elapsed();
+				emit signal_evaluated(evaluation);
+			}
+		}, Qt::QueuedConnection);
+
+		m_internal->m_thread.start();
+	}
+
+	InstanceEvaluator::~InstanceEvaluator()
+	{
+		cancel();
+
+		m_internal->m_thread.quit();
+		m_internal->m_thread.wait();
+	}
+
+
+
+	//================================================================================
+	// Evaluation
+	//================================================================================
+
+	void InstanceEvaluator::submit(InstanceSnapshotCPtr snapshot)
+	{
+		int generation = ++m_internal->m_generation;
+		emit signal_submitted(std::make_shared<InstanceEvaluation>(snapshot, generation));
+	}
+
+	void InstanceEvaluator::cancel()
+	{
+		m_internal->m_cancelled_generation = ++m_internal->m_generation;
+	}
+
+	bool InstanceEvaluator::is_latest(const InstanceEvaluation& evaluation) const
+	{
+		return (evaluation.m_generation == m_internal->m_generation.load());
+	}
+
+	bool InstanceEvaluator::is_cancelled(const InstanceEvaluation& evaluation) const
+	{
+		return (evaluation.m_generation < m_internal->m_cancelled_generation.load());
+	}
+}
\ No newline at end of file
@@ -0,0 +1,50 @@
+#ifndef INSTANCE_EVALUATOR_H
+#define INSTANCE_EVALUATOR_H
+
+// Project includes
+#include "Data/Instance/InstanceSnapshot.h"
+
+// Qt includes
+#include <QObject>
+
+// Stdlib includes
+#include <memory>
+
+
+namespace LTTPMapTracker
+{
+	// Instance Evaluator
+	//--------------------------------------------------------------------------------
+
+	// Evaluates snapshots on a worker thread. Submitting a snapshot supersedes any pass
+	// still running, which then stops at its next node, unless nothing has been reported
+	// for a while, in which case it finishes and reports anyway. Cancelling stops every
+	// pass submitted so far.
+
+	class InstanceEvaluator : public QObject
+	{
+		Q_OBJECT
+
+	public:
+		// Construction & Destruction
+								InstanceEvaluator	();
+								~InstanceEvaluator	();
+
+		// Evaluation
+		void					submit				(InstanceSnapshotCPtr snapshot);
+		void					cancel				();
+		bool					is_latest			(const InstanceEvaluation& evaluation) const;
+		bool					is_cancelled		(const InstanceEvaluation& evaluation) const;
+
+	signals:
+		// Signals
+		void					signal_submitted	(InstanceEvaluationPtr evaluation);
+		void					signal_evaluated	(InstanceEvaluationPtr evaluation);
+
+	private:
+		struct Internal;
+		const std::unique_ptr<Internal> m_internal;
+	};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,137 @@
+// Project includes
+#include "Data/Instance/InstanceProgressState.h"
+
+
+namespace LTTPMapTracker
+{
+	//================================================================================
+	// Construction
+	//================================================================================
+
+	InstanceProgressState::InstanceProgressState()
+		: m_num_pendants(0)
+		, m_num_pendants_green(0)
+		, m_num_crystals(0)
+		, m_num_crystals_red(0)
+		, m_epoch(0)
+	{
+	}
+
+
+
+	//================================================================================
+	// Modification
+	//================================================================================
+
+	void InstanceProgressState::reset(int num_entities)
+	{
+		m_items = QBitArray(num_entities);
+		m_locations_cleared = QBitArray(num_entities);
+		m_item_counts.fill(0, num_entities);
+		m_location_cleared_counts.fill(0, num_entities);
+
+		m_num_pendants = 0;
+		m_num_pendants_green = 0;
+		m_num_crystals = 0;
+		m_num_crystals_red = 0;
+
+		++m_epoch;
+	}
+
+	void InstanceProgressState::add_item(int entity_id)
+	{
+		count_item(entity_id, 1);
+	}
+
+	void InstanceProgressState::remove_item(int entity_id)
+	{
+		count_item(entity_id, -1);
+	}
+
+	void InstanceProgressState::add_location(int entity_id, const InstanceProgressLocationData& data)
+	{
+		count_location(entity_id, data, 1);
+	}
+
+	void InstanceProgressState::remove_location(int entity_id, const InstanceProgressLocationData& data)
+	{
+		count_location(entity_id, data, -1);
+	}
+
+
+
+	//================================================================================
+	// Queries
+	//================================================================================
+
+	bool InstanceProgressState::has_item(int entity_id) const
+	{
+		return (entity_id >= 0 && entity_id < m_items.size() && m_items.testBit(entity_id));
+	}
+
+	bool InstanceProgressState::is_location_cleared(int entity_id) const
+	{
+		return (entity_id >= 0 && entity_id < m_locations_cleared.size() && m_locations_cleared.testBit(entity_id));
+	}
+
+	int InstanceProgressState::get_num_pendants() const
+	{
+		return m_num_pendants;
+	}
+
+	int InstanceProgressState::get_num_pendants_green() const
+	{
+		return m_num_pendants_green;
+	}
+
+	int InstanceProgressState::get_num_crystals() const
+	{
+		return m_num_crystals;
+	}
+
+	int InstanceProgressState::get_num_crystals_red() const
+	{
+		return m_num_crystals_red;
+	}
+
+	quint64 InstanceProgressState::get_epoch() const
+	{
+		return m_epoch;
+	}
+
+
+
+	//================================================================================
+	// Helpers
+	//================================================================================
+
+	void InstanceProgressState::count_item(int entity_id, int sign)
+	{
+		if (entity_id >= 0 && entity_id < m_items.size())
+		{
+			m_item_counts[entity_id] += sign;
+			m_items.setBit(entity_id, m_item_counts[entity_id] > 0);
+
+			++m_epoch;
+		}
+	}
+
+	void InstanceProgressState::count_location(int entity_id, const InstanceProgressLocationData& data, int sign)
+	{
+		if (entity_id >= 0 && entity_id < m_locations_cleared.size())
+		{
+			if (data.m_cleared)
+			{
+				m_location_cleared_counts[entity_id] += sign;
+				m_locations_cleared.setBit(entity_id, m_location_cleared_counts[entity_id] > 0);
+
+				m_num_pendants += (data.m_is_pendant ? sign : 0);
+				m_num_pendants_green += (data.m_is_pendant_green ? sign : 0);
+				m_num_crystals += (data.m_is_crystal || data.m_is_crystal_red ? sign : 0);
+				m_num_crystals_red += (data.m_is_crystal_red ? sign : 0);
+			}
+
+			++m_epoch;
+		}
+	}
+}
\ No newline at end of file
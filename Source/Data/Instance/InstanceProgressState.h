@@ -0,0 +1,68 @@
+#ifndef INSTANCE_PROGRESS_STATE_H
+#define INSTANCE_PROGRESS_STATE_H
+
+// Project includes
+#include "Data/Instance/InstanceData.h"
+
+// Qt includes
+#include <QBitArray>
+#include <QVector>
+
+
+namespace LTTPMapTracker
+{
+	// Instance Progress State
+	//--------------------------------------------------------------------------------
+
+	// Progress items and locations flattened into bitsets indexed by entity id.
+	// Kept in step with the instance's progress containers; copies are implicitly
+	// shared, so taking a snapshot is cheap.
+	// The containers may hold several entries for one entity, so every entry is
+	// added and removed on its own: an entity stays set while any of its entries
+	// remains. Cleared pendant and crystal locations are counted per entry, which
+	// is all the ProgressSpecial rules need. The epoch goes up with every
+	// modification, so results derived from the state can be cached against it.
+
+	class InstanceProgressState
+	{
+	public:
+		// Construction
+				InstanceProgressState	();
+
+		// Modification
+		void	reset					(int num_entities);
+		void	add_item				(int entity_id);
+		void	remove_item				(int entity_id);
+		void	add_location			(int entity_id, const InstanceProgressLocationData& data);
+		void	remove_location			(int entity_id, const InstanceProgressLocationData& data);
+
+		// Queries
+		bool	has_item				(int entity_id) const;
+		bool	is_location_cleared		(int entity_id) const;
+
+		int		get_num_pendants		() const;
+		int		get_num_pendants_green	() const;
+		int		get_num_crystals		() const;
+		int		get_num_crystals_red	() const;
+
+		quint64	get_epoch				() const;
+
+	private:
+		void	count_item				(int entity_id, int sign);
+		void	count_location			(int entity_id, const InstanceProgressLocationData& data, int sign);
+
+		QBitArray		m_items;
+		QBitArray		m_locations_cleared;
+		QVector<int>	m_item_counts;
+		QVector<int>	m_location_cleared_counts;
+
+		int				m_num_pendants;
+		int				m_num_pendants_green;
+		int				m_num_crystals;
+		int				m_num_crystals_red;
+
+		quint64			m_epoch;
+	};
+}
+
+#endif
\ No newline at end of file
@@ -1,7 +1,10 @@
 // Project includes
 #include "Data/Instance/InstanceRuleParser.h"
+#include "Data/Database/EntityDatabase.h"
 #include "Data/Instance/Instance.h"
 #include "Data/Schema/Schema.h"
+#include "Data/Schema/SchemaRuleProgram.h"
+#include "Data/DataModel.h"
 
 
 namespace LTTPMapTracker
@@ -10,450 +13,347 @@ namespace LTTPMapTracker
 	// Rule
 	//================================================================================
 
-	bool match_rule(const Instance& instance, const SchemaRuleEntry& entry)
+	SchemaRuleProgramCPtr get_rule_program(const Instance& instance, SchemaRuleCPtr rule)
 	{
-		if (entry.m_type == SchemaRuleType::ProgressItem)
+		// Compile on first use; the schema drops the program whenever it changes.
+		auto& rule_data = rule->get();
+		if (rule_data.m_program == nullptr)
 		{
-			auto& progress_items = instance.progress_items().get();
-			auto it = std::find_if(progress_items.begin(), progress_items.end(), [&entry] (InstanceProgressItemCPtr progress_item)
-			{
-				return (progress_item->get().m_item->m_entity->m_type_name == entry.m_value);
-			});
-			return (it != progress_items.end());
+			rule_data.m_program = compile_rule_program(*instance.get_schema(), rule_data);
 		}
 
-		if (entry.m_type == SchemaRuleType::ProgressLocation)
-		{
-			auto& progress_locations = instance.progress_locations().get();
-			auto it = std::find_if(progress_locations.begin(), progress_locations.end(), [&entry] (InstanceProgressLocationCPtr progress_location)
-			{
-				return (progress_location->get().m_location->m_entity->m_type_name == entry.m_value);
-			});
-			return (it != progress_locations.end() && (*it)->get().m_cleared);
-		}
+		return rule_data.m_program;
+	}
 
-		if (entry.m_type == SchemaRuleType::ProgressSpecial)
+	bool match_rule(const InstanceProgressState& progress_state, SchemaRuleTypeProgressSpecial special)
+	{
+		switch (special)
 		{
-			auto info = EnumReflection<SchemaRuleTypeProgressSpecial>::info(entry.m_value);
-			return (info != nullptr && match_rule(instance, info->m_type));
+		case SchemaRuleTypeProgressSpecial::Pendant1: return (progress_state.get_num_pendants_green() >= 1);
+		case SchemaRuleTypeProgressSpecial::Pendant2: return (progress_state.get_num_pendants() >= 1);
+		case SchemaRuleTypeProgressSpecial::Pendant3: return (progress_state.get_num_pendants() >= 2);
+		case SchemaRuleTypeProgressSpecial::Crystal5: return (progress_state.get_num_crystals_red() >= 1);
+		case SchemaRuleTypeProgressSpecial::Crystal6: return (progress_state.get_num_crystals_red() >= 2);
+		case SchemaRuleTypeProgressSpecial::Crystal7: return (progress_state.get_num_crystals() >= 7);
 		}
 
-		if (entry.m_type == SchemaRuleType::SchemaRule)
-		{
-			auto rule = instance.get_schema()->rules().find(entry.m_value);
-			return (rule != nullptr && match_rule(instance, rule));
-		}
+		return false;
+	}
 
-		if (entry.m_type == SchemaRuleType::SchemaItem)
+
+
+	//================================================================================
+	// Solver
+	//================================================================================
+
+	namespace
+	{
+		void schedule_node(InstanceEvaluation& evaluation, int node)
 		{
-			auto schema_item = instance.get_schema()->items().find(entry.m_value);
-			return (schema_item != nullptr && match_rule(instance, schema_item));
+			if (!evaluation.m_node_queued[node])
+			{
+				evaluation.m_node_queued[node] = true;
+				evaluation.m_worklist << node;
+			}
 		}
 
-		if (entry.m_type == SchemaRuleType::SchemaRegion)
+		// Reads a node on behalf of the one being evaluated, which is re-evaluated should this
+		// node become accessible later. Nodes are first scheduled the first time they're read.
+		bool read_node(InstanceEvaluation& evaluation, int node)
 		{
-			auto schema_region = instance.get_schema()->regions().find(entry.m_value);
-			return (schema_region != nullptr && match_rule(instance, schema_region));
+			if (!evaluation.m_node_fixed[node] && !evaluation.m_node_accessible[node])
+			{
+				// Nodes re-read the same requirements every time they're re-evaluated; the set notes them once.
+				evaluation.m_node_dependents[node].insert(evaluation.m_current_node);
+
+				if (!evaluation.m_node_visited[node])
+				{
+					evaluation.m_node_visited[node] = true;
+					schedule_node(evaluation, node);
+				}
+			}
+
+			return evaluation.m_node_accessible[node];
 		}
 
-		if (entry.m_type == SchemaRuleType::Inaccessible)
+		bool read_requirement(InstanceEvaluation& evaluation, int node)
 		{
-			return false;
+			return (node == -1 || read_node(evaluation, node));
 		}
 
-		return false;
-	}
-	
-	bool match_rule(const Instance& instance, SchemaRuleTypeProgressSpecial special)
-	{
-		auto& progress_locations = instance.progress_locations().get();
-
-		switch (special)
+		// Entrance components are worked out once per location per pass; the progress state
+		// doesn't change during one.
+		const QVector<int>& get_location_components(InstanceEvaluation& evaluation, const Location& location)
 		{
-		case SchemaRuleTypeProgressSpecial::Pendant1: 
-			return (std::find_if(progress_locations.begin(), progress_locations.end(), [] (InstanceProgressLocationCPtr progress_location)
+			auto it = evaluation.m_location_components.find(&location);
+			if (it == evaluation.m_location_components.end())
 			{
-				return (progress_location->get().m_is_pendant_green && progress_location->get().m_cleared);
-			}) != progress_locations.end());
-
-		case SchemaRuleTypeProgressSpecial::Pendant2: 
-			return (std::count_if(progress_locations.begin(), progress_locations.end(), [] (InstanceProgressLocationCPtr progress_location)
-			{
-				return (progress_location->get().m_is_pendant && progress_location->get().m_cleared);
-			}) >= 1);
-
-		case SchemaRuleTypeProgressSpecial::Pendant3: 
-			return (std::count_if(progress_locations.begin(), progress_locations.end(), [] (InstanceProgressLocationCPtr progress_location)
-			{
-				return (progress_location->get().m_is_pendant && progress_location->get().m_cleared);
-			}) >= 2);
+				it = evaluation.m_location_components.insert(&location, match_location_components(location, evaluation.m_snapshot->m_progress_state));
+			}
 
-		case SchemaRuleTypeProgressSpecial::Crystal5: 
-			return (std::count_if(progress_locations.begin(), progress_locations.end(), [] (InstanceProgressLocationCPtr progress_location)
-			{
-				return (progress_location->get().m_is_crystal_red && progress_location->get().m_cleared);
-			}) >= 1);
+			return it.value();
+		}
 
-		case SchemaRuleTypeProgressSpecial::Crystal6: 
-			return (std::count_if(progress_locations.begin(), progress_locations.end(), [] (InstanceProgressLocationCPtr progress_location)
-			{
-				return (progress_location->get().m_is_crystal_red && progress_location->get().m_cleared);
-			}) >= 2);
+		bool evaluate_rule(InstanceEvaluation& evaluation, int rule_index)
+		{
+			auto& snapshot = *evaluation.m_snapshot;
+			auto& program = *snapshot.m_programs[rule_index];
+			auto& nodes = snapshot.m_program_nodes[rule_index];
 
-		case SchemaRuleTypeProgressSpecial::Crystal7: 
-			return (std::count_if(progress_locations.begin(), progress_locations.end(), [] (InstanceProgressLocationCPtr progress_location)
+			auto match_entry = [&evaluation, &program, &nodes] (int index)
 			{
-				return ((progress_location->get().m_is_crystal || progress_location->get().m_is_crystal_red) && progress_location->get().m_cleared);
-			}) >= 7);
-		}
+				auto& entry = program.m_entries[index];
+				auto& progress_state = evaluation.m_snapshot->m_progress_state;
 
-		return false;
-	}
+				switch (entry.m_type)
+				{
+				case SchemaRuleType::ProgressItem:
+					return progress_state.has_item(entry.m_entity);
 
-	bool match_rule(const Instance& instance, SchemaRuleCPtr rule)
-	{
-		// Ensure we're not infinite looping.
-		static QVector<SchemaRuleCPtr> rules;
-		
-		if (rules.contains(rule))
-		{
-			return false;
-		}
+				case SchemaRuleType::ProgressLocation:
+					return progress_state.is_location_cleared(entry.m_entity);
 
-		rules << rule;
+				case SchemaRuleType::ProgressSpecial:
+					return match_rule(progress_state, entry.m_special);
 
-		// Build an expression tree.
-		struct ExpressionNode
-		{
-			SchemaRuleOperator						 m_operator;
-			const SchemaRuleEntry*					 m_entry;
-			QVector<std::shared_ptr<ExpressionNode>> m_children;
-			std::weak_ptr<ExpressionNode>			 m_parent;
+				case SchemaRuleType::SchemaRule:
+				case SchemaRuleType::SchemaItem:
+				case SchemaRuleType::SchemaRegion:
+					return (nodes[index] != -1 && read_node(evaluation, nodes[index]));
 
-			ExpressionNode() : m_operator(SchemaRuleOperator::Or), m_entry(nullptr) {}
-		};
+				case SchemaRuleType::Inaccessible:
+					return false;
+				}
 
-		auto root = std::make_shared<ExpressionNode>();
-		auto node = root;
+				return false;
+			};
 
-		auto& entries = rule->get().m_entries;
-		for (int entry_index = 0; entry_index < entries.size(); ++entry_index)
-		{
-			auto& entry = entries[entry_index];
+			bool result = program.m_valid;
 
-			for (int i = 0; i < entry.m_brackets_open + 1; ++i)
+			auto& instructions = program.m_instructions;
+			for (int pc = 0; pc < instructions.size() && program.m_valid; ++pc)
 			{
-				if (node->m_children.size() == 2)
+				auto& instruction = instructions[pc];
+
+				switch (instruction.m_opcode)
 				{
-					auto proxy_node = std::make_shared<ExpressionNode>();
-					proxy_node->m_operator = entries[entry_index - 1].m_operator;
+				case SchemaRuleOpcode::Entry:
+					result = match_entry(instruction.m_operand);
+					break;
 
-					auto parent = node->m_parent.lock();
-					if (parent != nullptr)
+				case SchemaRuleOpcode::True:
+					result = true;
+					break;
+
+				case SchemaRuleOpcode::JumpIfTrue:
+					if (result)
 					{
-						parent->m_children.removeOne(node);
-						parent->m_children << proxy_node;
+						pc = instruction.m_operand - 1;
 					}
+					break;
 
-					proxy_node->m_parent = node->m_parent;
-					node->m_parent = proxy_node;
-					proxy_node->m_children << node;
-					
-					if (node == root)
+				case SchemaRuleOpcode::JumpIfFalse:
+					if (!result)
 					{
-						root = proxy_node;
+						pc = instruction.m_operand - 1;
 					}
-
-					node = proxy_node;
+					break;
 				}
-
-				auto new_node = std::make_shared<ExpressionNode>();
-				node->m_children << new_node;
-				new_node->m_parent = node;
-				node = new_node;
 			}
 
-			node->m_entry = &entry;
+			return result;
+		}
+
+		bool evaluate_item(InstanceEvaluation& evaluation, int item_index)
+		{
+			auto& snapshot = *evaluation.m_snapshot;
+			auto& item = snapshot.m_items[item_index];
 
-			for (int i = 0; i < entry.m_brackets_close; ++i)
+			// Its own region and rule.
+			if (read_requirement(evaluation, snapshot.m_item_region_nodes[item_index]) &&
+				read_requirement(evaluation, snapshot.m_item_rule_nodes[item_index]))
 			{
-				node = node->m_parent.lock();
+				return true;
 			}
 
-			auto parent = node->m_parent.lock();
-			if (parent->m_children.size() == 1)
+			// Anything it's connected to.
+			for (int other_index : snapshot.m_item_neighbours[item_index])
 			{
-				parent->m_operator = entry.m_operator;
+				if (read_node(evaluation, snapshot.item_node(other_index)))
+				{
+					return true;
+				}
 			}
 
-			node = parent;
-		}
+			// Start positions, and other entrances into the same location.
+			auto location = item.m_location;
 
-		// Evaluate the expression.
-		std::function<bool(const ExpressionNode&)> evaluate = [&evaluate, &instance] (const ExpressionNode& node)
-		{
-			if (node.m_entry != nullptr)
-			{
-				return match_rule(instance, *node.m_entry);
-			}
-			else if (node.m_children.isEmpty())
+			if (location != nullptr && location->m_is_startpos)
 			{
 				return true;
 			}
-			else
+
+			if (location != nullptr && !location->m_entrances.isEmpty())
 			{
-				auto result = evaluate(*node.m_children[0]);
-				if (node.m_children.size() == 2)
+				for (int other_index : snapshot.m_location_items.value(location.get()))
 				{
-					auto result2 = evaluate(*node.m_children[1]);
-					result = (node.m_operator == SchemaRuleOperator::Or ? result || result2 : result && result2);
+					if (other_index != item_index && read_node(evaluation, snapshot.item_node(other_index)))
+					{
+						return true;
+					}
 				}
-				return result;
 			}
-		};
-
-		bool result = evaluate(*root);
-
-		rules.removeOne(rule);
-
-		return result;
-	}
 
-
-
-	//================================================================================
-	// Schema
-	//================================================================================
-
-	bool match_rule(const Instance& instance, SchemaItemCPtr schema_item)
-	{
-		// Ensure we're not infinite looping.
-		static QVector<SchemaItemCPtr> schema_items;
-		
-		if (schema_items.contains(schema_item))
-		{
 			return false;
 		}
 
-		schema_items << schema_item;
-
-		if ((schema_item->get().m_region == nullptr || match_rule(instance, schema_item->get().m_region)) &&
-			(schema_item->get().m_rule == nullptr || match_rule(instance, schema_item->get().m_rule)))
+		bool evaluate_region(InstanceEvaluation& evaluation, int region_index)
 		{
-			schema_items.removeOne(schema_item);
-			return true;
-		}
+			auto& snapshot = *evaluation.m_snapshot;
+			int region_node = snapshot.region_node(region_index);
 
-		auto& connections = instance.connections().get();
-		for (auto connection : connections)
-		{
-			auto& items = connection->get().m_items;
-			if (std::none_of(items.begin(), items.end(), [schema_item] (InstanceItemCPtr item)
+			// Its own rule.
+			if (read_requirement(evaluation, snapshot.m_region_rule_nodes[region_index]))
 			{
-				return (item->get().m_schema_item == schema_item);
-			}))
-			{
-				continue;
+				return true;
 			}
 
-			auto this_item = (items[0]->get().m_schema_item == schema_item ? items[0] : items[1]);
-			auto other_item = (this_item == items[0] ? items[1] : items[0]);
-
-			if (match_rule(instance, other_item->get().m_schema_item))
+			for (int item_index : snapshot.m_region_items[region_index])
 			{
-				schema_items.removeOne(schema_item);
-				return true;
-			}
-		}
+				auto& item = snapshot.m_items[item_index];
+				auto& schema_item = item.m_schema_item->get();
 
-		auto& items = instance.items();
-		auto instance_item_it = std::find_if(items.begin(), items.end(), [schema_item] (InstanceItemCPtr item)
-		{
-			return (item->get().m_schema_item == schema_item);
-		});
-		Q_ASSERT(instance_item_it != items.end());
-		auto instance_item = *instance_item_it;
+				auto is_entrance_open = [&] ()
+				{
+					return (schema_item.m_rule == nullptr || schema_item.m_rule_access == SchemaRuleAccessType::Entrance || read_node(evaluation, snapshot.m_item_rule_nodes[item_index]));
+				};
 
-		bool is_start_pos = (instance_item->get().m_location != nullptr && instance_item->get().m_location->m_is_startpos);
-		if (is_start_pos)
-		{
-			schema_items.removeOne(schema_item);
-			return true;
-		}
+				// Connections from one of its items into somewhere accessible.
+				for (int other_index : snapshot.m_item_neighbours[item_index])
+				{
+					if (snapshot.m_item_region_nodes[other_index] == region_node)
+					{
+						return true;
+					}
 
-		auto location = instance_item->get().m_location;
-		if (location != nullptr && !location->m_entrances.isEmpty())
-		{
-			for (auto item : items)
-			{
-				auto other_location = item->get().m_location;
+					if (is_entrance_open() && read_node(evaluation, snapshot.item_node(other_index)))
+					{
+						return true;
+					}
+				}
+
+				auto location = item.m_location;
+				if (location == nullptr)
+				{
+					continue;
+				}
+
+				// Start positions.
+				if (location->m_is_startpos && is_entrance_open())
+				{
+					return true;
+				}
 
-				if (item != instance_item && other_location == location && match_rule(instance, item))
+				// Paths through a location from an entrance in another region.
+				int source_index = snapshot.m_item_location_sources[item_index];
+				if (source_index != -1 &&
+					read_node(evaluation, snapshot.item_node(source_index)) &&
+					read_requirement(evaluation, snapshot.m_item_region_nodes[source_index]) &&
+					is_location_connected(*location, get_location_components(evaluation, *location), snapshot.m_items[source_index].m_location_entrance, item.m_location_entrance))
 				{
-					schema_items.removeOne(schema_item);
 					return true;
 				}
 			}
+
+			return false;
 		}
 
-		schema_items.removeOne(schema_item);
+		bool evaluate_node(InstanceEvaluation& evaluation, int node)
+		{
+			auto& snapshot = *evaluation.m_snapshot;
 
-		return false;
+			if (node < snapshot.item_node(0))
+			{
+				return evaluate_region(evaluation, node - snapshot.region_node(0));
+			}
+
+			if (node < snapshot.rule_node(0))
+			{
+				return evaluate_item(evaluation, node - snapshot.item_node(0));
+			}
+
+			return evaluate_rule(evaluation, node - snapshot.rule_node(0));
+		}
 	}
 
-	bool match_rule(const Instance& instance, SchemaRegionCPtr schema_region)
+
+
+	//================================================================================
+	// Evaluation
+	//================================================================================
+
+	bool evaluate_accessibility(InstanceEvaluation& evaluation, std::function<bool()> is_cancelled)
 	{
-		if (schema_region->get().m_accessible_cached)
+		auto& snapshot = *evaluation.m_snapshot;
+
+		for (int region_index : snapshot.m_dirty_regions)
 		{
-			return schema_region->get().m_accessible;
+			evaluation.m_node_visited[snapshot.region_node(region_index)] = true;
+			schedule_node(evaluation, snapshot.region_node(region_index));
 		}
 
-		auto& connections = instance.connections().get();
-		QVector<SchemaRegionCPtr> regions;
+		for (int item_index : snapshot.m_dirty_items)
+		{
+			evaluation.m_node_visited[snapshot.item_node(item_index)] = true;
+			schedule_node(evaluation, snapshot.item_node(item_index));
+		}
 
-		std::function<bool(SchemaRegionCPtr)> check_region = [&check_region, &instance, &connections, &regions] (SchemaRegionCPtr region)
+		while (!evaluation.m_worklist.isEmpty())
 		{
-			if (regions.contains(region))
+			if (is_cancelled())
 			{
 				return false;
 			}
 
-			regions << region;
+			int node = evaluation.m_worklist.takeLast();
+			evaluation.m_node_queued[node] = false;
 
-			if (region == nullptr || region->get().m_rule == nullptr || match_rule(instance, region->get().m_rule))
+			if (evaluation.m_node_accessible[node])
 			{
-				regions.removeOne(region);
-				return true;
+				continue;
 			}
 
-			for (auto connection : connections)
-			{
-				auto& items = connection->get().m_items;
-				if (std::none_of(items.begin(), items.end(), [region] (InstanceItemCPtr item)
-				{
-					return (item->get().m_schema_item->get().m_region == region);
-				}))
-				{
-					continue;
-				}
+			evaluation.m_current_node = node;
 
-				auto this_item = (items[0]->get().m_schema_item->get().m_region == region ? items[0] : items[1]);
-				auto other_item = (this_item == items[0] ? items[1] : items[0]);
-
-				if (this_item->get().m_schema_item->get().m_region == other_item->get().m_schema_item->get().m_region)
-				{
-					regions.removeOne(region);
-					return true;
-				}
-
-				auto this_rule = this_item->get().m_schema_item->get().m_rule;
-				auto this_rule_access = this_item->get().m_schema_item->get().m_rule_access;
-
-				if (this_item->get().m_schema_item->get().m_region == region && (this_rule == nullptr || this_rule_access == SchemaRuleAccessType::Entrance || match_rule(instance, this_rule)) && match_rule(instance, other_item))
-				{
-					regions.removeOne(region);
-					return true;
-				}
-			}
-
-			auto& items = instance.items();
-			for (auto item : items)
+			if (evaluate_node(evaluation, node))
 			{
-				auto location = item->get().m_location;
+				// Accessibility only ever grows, so whatever was waiting on this node gets another look.
+				evaluation.m_node_accessible[node] = true;
 
-				if (location != nullptr && item->get().m_schema_item->get().m_region == region)
+				for (int dependent : evaluation.m_node_dependents[node])
 				{
-					if (location->m_is_startpos)
+					if (!evaluation.m_node_accessible[dependent])
 					{
-						auto rule = item->get().m_schema_item->get().m_rule;
-						auto rule_access = item->get().m_schema_item->get().m_rule_access;
-						
-						if (rule == nullptr || rule_access == SchemaRuleAccessType::Entrance || match_rule(instance, rule))
-						{
-							regions.removeOne(region);
-							return true;
-						}
+						schedule_node(evaluation, dependent);
 					}
 				}
 
-				if (location != nullptr && !location->m_connections.isEmpty() && item->get().m_schema_item->get().m_region == region)
-				{
-					auto it = std::find_if(items.begin(), items.end(), [location, item, region] (InstanceItemCPtr other_item)
-					{
-						return (other_item->get().m_location == location && other_item != item && other_item->get().m_schema_item->get().m_region != region);
-					});
-
-					if (it != items.end() && match_rule(instance, *it) && check_region((*it)->get().m_schema_item->get().m_region))
-					{
-						auto e1 = item->get().m_location_entrance;
-						auto e2 = (*it)->get().m_location_entrance;
-
-						QVector<LocationConnection> checked;
-						std::function<bool(EntityCPtr)> check = [&check, &checked, location, e1, &instance] (EntityCPtr entrance)
-						{
-							for (auto& connection : location->m_connections)
-							{
-								if (!connection.m_entrances.contains(entrance))
-								{
-									continue;
-								}
-
-								auto is_checked = std::any_of(checked.begin(), checked.end(), [&connection] (const LocationConnection& connection_)
-								{
-									return (connection_.m_entrances == connection.m_entrances);
-								});
-
-								if (is_checked)
-								{
-									continue;
-								}
-
-								checked << connection;
-
-								if (connection.m_entrances.contains(e1))
-								{
-									return true;
-								}
-
-								if (match_location_requirements(connection.m_requirements, instance) == LocationMatch::No)
-								{
-									continue;
-								}
-
-								if (check(connection.m_entrances[0] != entrance ? connection.m_entrances[0] : connection.m_entrances[1]))
-								{
-									return true;
-								}
-							}
-
-							return false;
-						};
-
-						if (check(e2))
-						{
-							regions.removeOne(region);
-							return true;
-						}
-					}
-				}
+				evaluation.m_node_dependents[node].clear();
 			}
+		}
 
-			regions.removeOne(region);
-
-			return false;
-		};
-
-		return check_region(schema_region);
-	}
-
+		evaluation.m_current_node = -1;
 
+		for (int region_index : snapshot.m_dirty_regions)
+		{
+			evaluation.m_region_accessible[region_index] = evaluation.m_node_accessible[snapshot.region_node(region_index)];
+		}
 
-	//================================================================================
-	// Instance
-	//================================================================================
+		for (int item_index : snapshot.m_dirty_items)
+		{
+			evaluation.m_item_accessible[item_index] = evaluation.m_node_accessible[snapshot.item_node(item_index)];
+		}
 
-	bool match_rule(const Instance& instance, InstanceItemCPtr instance_item)
-	{
-		return match_rule(instance, instance_item->get().m_schema_item);
+		return true;
 	}
 }
\ No newline at end of file
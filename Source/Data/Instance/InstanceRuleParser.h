@@ -2,10 +2,14 @@
 #define INSTANCE_RULE_PARSER_H
 
 // Project includes
+#include "Data/Instance/InstanceSnapshot.h"
 #include "Data/Instance/InstanceTypeInfo.h"
 #include "Data/Schema/SchemaTypeInfo.h"
 #include "Utility/Result.h"
 
+// Stdlib includes
+#include <functional>
+
 // Forward declarations
 namespace LTTPMapTracker
 {
@@ -16,16 +20,15 @@ namespace LTTPMapTracker
 namespace LTTPMapTracker
 {
 	// Rule
-	bool match_rule(const Instance& instance, const SchemaRuleEntry& entry);
-	bool match_rule(const Instance& instance, SchemaRuleTypeProgressSpecial special);
-	bool match_rule(const Instance& instance, SchemaRuleCPtr rule);
+	SchemaRuleProgramCPtr get_rule_program(const Instance& instance, SchemaRuleCPtr rule);
 
-	// Schema
-	bool match_rule(const Instance& instance, SchemaItemCPtr schema_item);
-	bool match_rule(const Instance& instance, SchemaRegionCPtr schema_region);
+	bool match_rule(const InstanceProgressState& progress_state, SchemaRuleTypeProgressSpecial special);
 
-	// Instance
-	bool match_rule(const Instance& instance, InstanceItemCPtr instance_item);
+	// Evaluation
+	// Solves accessibility of the snapshot's invalidated regions and items as a least fixpoint:
+	// nodes only ever become accessible, and a node is re-evaluated only when something it
+	// read has. Returns false if cancelled part way.
+	bool evaluate_accessibility(InstanceEvaluation& evaluation, std::function<bool()> is_cancelled);
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,301 @@
+// Project includes
+#include "Data/Instance/InstanceSnapshot.h"
+#include "Data/Database/LocationDatabase.h"
+#include "Data/Schema/SchemaData.h"
+#include "Data/Schema/SchemaRuleProgram.h"
+
+
+namespace LTTPMapTracker
+{
+	//================================================================================
+	// Instance Snapshot
+	//================================================================================
+
+	void InstanceSnapshot::index_schema()
+	{
+		m_region_indices.clear();
+		m_item_indices.clear();
+		m_rule_indices.clear();
+
+		for (int i = 0; i < m_regions.size(); ++i)
+		{
+			m_region_indices.insert(m_regions[i].get(), i);
+		}
+
+		for (int i = 0; i < m_items.size(); ++i)
+		{
+			m_item_indices.insert(m_items[i].m_schema_item.get(), i);
+		}
+
+		for (int i = 0; i < m_rules.size(); ++i)
+		{
+			m_rule_indices.insert(m_rules[i].get(), i);
+		}
+
+		// Requirements of regions and items; these always refer to the schema's own regions and rules.
+		auto region_requirement = [this] (SchemaRegionCPtr region)
+		{
+			Q_ASSERT(region == nullptr || region_index(region) != -1);
+			return (region != nullptr ? region_node(region_index(region)) : -1);
+		};
+
+		auto rule_requirement = [this] (SchemaRuleCPtr rule)
+		{
+			Q_ASSERT(rule == nullptr || rule_index(rule) != -1);
+			return (rule != nullptr ? rule_node(rule_index(rule)) : -1);
+		};
+
+		m_region_rule_nodes.clear();
+		m_region_items = QVector<QVector<int>>(m_regions.size());
+
+		for (auto& region : m_regions)
+		{
+			m_region_rule_nodes << rule_requirement(region->get().m_rule);
+		}
+
+		m_item_region_nodes.clear();
+		m_item_rule_nodes.clear();
+
+		for (int i = 0; i < m_items.size(); ++i)
+		{
+			auto& schema_item = m_items[i].m_schema_item->get();
+			m_item_region_nodes << region_requirement(schema_item.m_region);
+			m_item_rule_nodes << rule_requirement(schema_item.m_rule);
+
+			int index = region_index(schema_item.m_region);
+			if (index != -1)
+			{
+				m_region_items[index] << i;
+			}
+		}
+
+		// Rule program entries. Unresolved references stay -1 and never match.
+		m_program_nodes.clear();
+
+		for (auto& program : m_programs)
+		{
+			QVector<int> nodes;
+
+			for (auto& entry : program->m_entries)
+			{
+				int node = -1;
+
+				switch (entry.m_type)
+				{
+				case SchemaRuleType::SchemaRule:
+					{
+						int index = rule_index(entry.m_rule.lock());
+						node = (index != -1 ? rule_node(index) : -1);
+					}
+					break;
+
+				case SchemaRuleType::SchemaItem:
+					{
+						int index = item_index(entry.m_item.lock());
+						node = (index != -1 ? item_node(index) : -1);
+					}
+					break;
+
+				case SchemaRuleType::SchemaRegion:
+					{
+						int index = region_index(entry.m_region.lock());
+						node = (index != -1 ? region_node(index) : -1);
+					}
+					break;
+				}
+
+				nodes << node;
+			}
+
+			m_program_nodes << nodes;
+		}
+	}
+
+	void InstanceSnapshot::index_instance()
+	{
+		// Connections are maintained separately, see add_connection().
+		m_location_items.clear();
+		m_item_location_sources.fill(-1, m_items.size());
+
+		for (int i = 0; i < m_items.size(); ++i)
+		{
+			if (m_items[i].m_location != nullptr)
+			{
+				m_location_items[m_items[i].m_location.get()] << i;
+			}
+		}
+
+		for (auto it = m_location_items.begin(); it != m_location_items.end(); ++it)
+		{
+			index_location(it.key());
+		}
+	}
+
+	void InstanceSnapshot::set_item(int item_index, const InstanceItemData& data)
+	{
+		auto old_location = m_items[item_index].m_location;
+		m_items[item_index] = data;
+
+		if (data.m_location == old_location)
+		{
+			return;
+		}
+
+		// Only the items at the old and new location need their paths looked at again.
+		if (old_location != nullptr)
+		{
+			auto it = m_location_items.find(old_location.get());
+			it->removeOne(item_index);
+
+			if (it->isEmpty())
+			{
+				m_location_items.erase(it);
+			}
+			else
+			{
+				index_location(old_location.get());
+			}
+		}
+
+		m_item_location_sources[item_index] = -1;
+
+		if (data.m_location != nullptr)
+		{
+			m_location_items[data.m_location.get()] << item_index;
+			index_location(data.m_location.get());
+		}
+	}
+
+	void InstanceSnapshot::add_connection(int item_index_a, int item_index_b)
+	{
+		m_item_neighbours[item_index_a] << item_index_b;
+
+		if (item_index_b != item_index_a)
+		{
+			m_item_neighbours[item_index_b] << item_index_a;
+		}
+	}
+
+	void InstanceSnapshot::remove_connection(int item_index_a, int item_index_b)
+	{
+		m_item_neighbours[item_index_a].removeOne(item_index_b);
+
+		if (item_index_b != item_index_a)
+		{
+			m_item_neighbours[item_index_b].removeOne(item_index_a);
+		}
+	}
+
+	void InstanceSnapshot::clear_connections()
+	{
+		m_item_neighbours = QVector<QVector<int>>(m_items.size());
+	}
+
+	int InstanceSnapshot::region_index(SchemaRegionCPtr region) const
+	{
+		return (region != nullptr ? m_region_indices.value(region.get(), -1) : -1);
+	}
+
+	int InstanceSnapshot::item_index(SchemaItemCPtr schema_item) const
+	{
+		return (schema_item != nullptr ? m_item_indices.value(schema_item.get(), -1) : -1);
+	}
+
+	int InstanceSnapshot::rule_index(SchemaRuleCPtr rule) const
+	{
+		return (rule != nullptr ? m_rule_indices.value(rule.get(), -1) : -1);
+	}
+
+	int InstanceSnapshot::region_node(int region_index) const
+	{
+		return region_index;
+	}
+
+	int InstanceSnapshot::item_node(int item_index) const
+	{
+		return m_regions.size() + item_index;
+	}
+
+	int InstanceSnapshot::rule_node(int rule_index) const
+	{
+		return m_regions.size() + m_items.size() + rule_index;
+	}
+
+	int InstanceSnapshot::num_nodes() const
+	{
+		return m_regions.size() + m_items.size() + m_rules.size();
+	}
+
+
+
+	//--------------------------------------------------------------------------------
+
+	void InstanceSnapshot::index_location(const Location* location)
+	{
+		// Paths through a location start from the first of its items in another region.
+		auto& items = m_location_items[location];
+
+		for (int i : items)
+		{
+			m_item_location_sources[i] = -1;
+
+			if (location->m_connections.isEmpty())
+			{
+				continue;
+			}
+
+			for (int index : items)
+			{
+				if (index != i && m_item_region_nodes[index] != m_item_region_nodes[i])
+				{
+					m_item_location_sources[i] = index;
+					break;
+				}
+			}
+		}
+	}
+
+
+
+	//================================================================================
+	// Instance Evaluation
+	//================================================================================
+
+	InstanceEvaluation::InstanceEvaluation(InstanceSnapshotCPtr snapshot, int generation)
+		: m_snapshot(snapshot)
+		, m_generation(generation)
+		, m_region_accessible(snapshot->m_region_accessible)
+		, m_item_accessible(snapshot->m_item_accessible)
+		, m_node_accessible(snapshot->num_nodes(), false)
+		, m_node_fixed(snapshot->num_nodes(), false)
+		, m_node_visited(snapshot->num_nodes(), false)
+		, m_node_queued(snapshot->num_nodes(), false)
+		, m_node_dependents(snapshot->num_nodes())
+		, m_current_node(-1)
+	{
+		// Regions and items keep their previous results unless invalidated. Rules are always solved.
+		for (int i = 0; i < snapshot->m_regions.size(); ++i)
+		{
+			m_node_accessible[snapshot->region_node(i)] = m_region_accessible[i];
+			m_node_fixed[snapshot->region_node(i)] = true;
+		}
+
+		for (int i = 0; i < snapshot->m_items.size(); ++i)
+		{
+			m_node_accessible[snapshot->item_node(i)] = m_item_accessible[i];
+			m_node_fixed[snapshot->item_node(i)] = true;
+		}
+
+		for (int region_index : snapshot->m_dirty_regions)
+		{
+			m_node_accessible[snapshot->region_node(region_index)] = false;
+			m_node_fixed[snapshot->region_node(region_index)] = false;
+		}
+
+		for (int item_index : snapshot->m_dirty_items)
+		{
+			m_node_accessible[snapshot->item_node(item_index)] = false;
+			m_node_fixed[snapshot->item_node(item_index)] = false;
+		}
+	}
+}
\ No newline at end of file
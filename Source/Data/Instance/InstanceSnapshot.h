@@ -0,0 +1,132 @@
+#ifndef INSTANCE_SNAPSHOT_H
+#define INSTANCE_SNAPSHOT_H
+
+// Project includes
+#include "Data/Instance/InstanceData.h"
+#include "Data/Instance/InstanceProgressState.h"
+#include "Data/Schema/SchemaTypeInfo.h"
+
+// Qt includes
+#include <QHash>
+#include <QMetaType>
+#include <QSet>
+#include <QVector>
+
+// Stdlib includes
+#include <memory>
+
+
+namespace LTTPMapTracker
+{
+	// Types
+	//--------------------------------------------------------------------------------
+
+	struct InstanceSnapshot;
+	using InstanceSnapshotCPtr = std::shared_ptr<const InstanceSnapshot>;
+
+	struct InstanceEvaluation;
+	using InstanceEvaluationPtr = std::shared_ptr<InstanceEvaluation>;
+
+
+	// Instance Snapshot
+	//--------------------------------------------------------------------------------
+
+	// Everything accessibility evaluation reads, copied out of an instance so it can be
+	// evaluated away from the GUI thread. The schema is shared rather than copied; it is
+	// not edited while an instance exists. Rule programs are compiled up front so nothing
+	// is written to schema data during evaluation.
+	//
+	// The instance keeps one snapshot up to date as it's edited and hands out copies. All
+	// tables are implicitly shared, so a copy is cheap and edits made while a pass still
+	// holds one only detach the tables they touch.
+	//
+	// Regions, items and rules form the nodes of the accessibility graph, numbered in that
+	// order. Node references in the tables below are -1 where there is no requirement.
+
+	struct InstanceSnapshot
+	{
+		SchemaCPtr								m_schema;
+		QVector<SchemaRegionCPtr>				m_regions;
+		QVector<SchemaRuleCPtr>					m_rules;
+		QVector<SchemaRuleProgramCPtr>			m_programs;
+		QVector<InstanceItemData>				m_items;
+		InstanceProgressState					m_progress_state;
+
+		// Schema indices, see index_schema().
+		QHash<const SchemaRegion*, int>			m_region_indices;
+		QHash<const SchemaItem*, int>			m_item_indices;
+		QHash<const SchemaRule*, int>			m_rule_indices;
+		QVector<int>							m_region_rule_nodes;
+		QVector<int>							m_item_region_nodes;
+		QVector<int>							m_item_rule_nodes;
+		QVector<QVector<int>>					m_region_items;
+		QVector<QVector<int>>					m_program_nodes;
+
+		// Instance indices, see index_instance(). Connections are stored as the items on
+		// their other end.
+		QVector<QVector<int>>					m_item_neighbours;
+		QHash<const Location*, QVector<int>>	m_location_items;
+		QVector<int>							m_item_location_sources;
+
+		// Results of the last applied pass, and what has been invalidated since.
+		QVector<bool>							m_region_accessible;
+		QVector<bool>							m_item_accessible;
+		QVector<int>							m_dirty_regions;
+		QVector<int>							m_dirty_items;
+
+		void	index_schema		();
+		void	index_instance		();
+
+		void	set_item			(int item_index, const InstanceItemData& data);
+		void	add_connection		(int item_index_a, int item_index_b);
+		void	remove_connection	(int item_index_a, int item_index_b);
+		void	clear_connections	();
+
+		int		region_index		(SchemaRegionCPtr region) const;
+		int		item_index			(SchemaItemCPtr schema_item) const;
+		int		rule_index			(SchemaRuleCPtr rule) const;
+
+		int		region_node			(int region_index) const;
+		int		item_node			(int item_index) const;
+		int		rule_node			(int rule_index) const;
+		int		num_nodes			() const;
+
+	private:
+		void	index_location		(const Location* location);
+	};
+
+
+	// Instance Evaluation
+	//--------------------------------------------------------------------------------
+
+	// The results of evaluating a snapshot, along with the solver state. Regions and items
+	// outside the dirty set keep the accessibility they had when the snapshot was taken.
+	// Nothing here is shared, so evaluations may run concurrently.
+
+	struct InstanceEvaluation
+	{
+		InstanceSnapshotCPtr	m_snapshot;
+		int						m_generation;
+
+		QVector<bool>			m_region_accessible;
+		QVector<bool>			m_item_accessible;
+
+		// Solver state, per node.
+		QVector<bool>			m_node_accessible;
+		QVector<bool>			m_node_fixed;
+		QVector<bool>			m_node_visited;
+		QVector<bool>			m_node_queued;
+		QVector<QSet<int>>		m_node_dependents;
+		QVector<int>			m_worklist;
+		int						m_current_node;
+
+		// Entrance components per location, see match_location_components().
+		QHash<const Location*, QVector<int>>	m_location_components;
+
+		InstanceEvaluation(InstanceSnapshotCPtr snapshot, int generation);
+	};
+}
+
+Q_DECLARE_METATYPE(LTTPMapTracker::InstanceEvaluationPtr);
+
+#endif
\ No newline at end of file
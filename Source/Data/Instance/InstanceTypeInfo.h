@@ -26,6 +26,8 @@ namespace LTTPMapTracker
 	class InstanceProgressLocation;
 	using InstanceProgressLocationPtr = std::shared_ptr<InstanceProgressLocation>;
 	using InstanceProgressLocationCPtr = std::shared_ptr<const InstanceProgressLocation>;
+
+	class InstanceProgressState;
 }
 
 #endif
\ No newline at end of file
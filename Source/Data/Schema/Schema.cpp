@@ -38,9 +38,9 @@ namespace LTTPMapTracker
 	}
 
 	template <typename T>
-	bool compare_name(std::shared_ptr<const T> data, QString name)
+	QVector<QString> get_name_keys(std::shared_ptr<const T> data)
 	{
-		return (data->get().m_name == name);
+		return QVector<QString>() << data->get().m_name;
 	}
 }
 
@@ -62,9 +62,9 @@ namespace LTTPMapTracker
 
 		Internal(Schema& schema)
 			: m_dirty(false)
-			, m_items(std::bind(&Schema::create_item, &schema), std::bind(&Schema::create_item, &schema), compare_name<SchemaItem>)
-			, m_regions(std::bind(&Schema::create_region, &schema), std::bind(&Schema::create_region, &schema), compare_name<SchemaRegion>)
-			, m_rules(std::bind(&Schema::create_rule, &schema), std::bind(&Schema::create_rule, &schema), compare_name<SchemaRule>)
+			, m_items(std::bind(&Schema::create_item, &schema), std::bind(&Schema::create_item, &schema), get_name_keys<SchemaItem>)
+			, m_regions(std::bind(&Schema::create_region, &schema), std::bind(&Schema::create_region, &schema), get_name_keys<SchemaRegion>)
+			, m_rules(std::bind(&Schema::create_rule, &schema), std::bind(&Schema::create_rule, &schema), get_name_keys<SchemaRule>)
 		{
 		}
 	};
@@ -138,7 +138,7 @@ namespace LTTPMapTracker
 		return Result();
 	}
 
-	Result Schema::load(QString filename)
+	Result Schema::load(QString filename, const EntityDatabase& entity_db)
 	{
 		// Load data.
 		QJsonObject json;
@@ -158,7 +158,7 @@ namespace LTTPMapTracker
 
 		Result result;
 		
-		result << m_internal->m_rules.deserialise("Rules", json, version, *this);
+		result << m_internal->m_rules.deserialise("Rules", json, version, *this, entity_db);
 		result << m_internal->m_regions.deserialise("Regions", json, version, *this);
 		result << m_internal->m_items.deserialise("Items", json, version, *this);
 		
@@ -301,7 +301,18 @@ namespace LTTPMapTracker
 
 	void Schema::set_dirty()
 	{
+		clear_rule_programs();
+
 		m_internal->m_dirty = true;
 		emit signal_dirty_state_changed(true);
 	}
+
+	void Schema::clear_rule_programs()
+	{
+		// Programs resolve names up front, so any edit may leave them stale.
+		for (auto rule : m_internal->m_rules.get())
+		{
+			rule->get().m_program.reset();
+		}
+	}
 }
\ No newline at end of file
@@ -12,6 +12,12 @@
 // Stdlib includes
 #include <memory>
 
+// Forward declarations
+namespace LTTPMapTracker
+{
+	class EntityDatabase;
+}
+
 
 namespace LTTPMapTracker
 {
@@ -38,7 +44,7 @@ namespace LTTPMapTracker
 		// Save & Load
 		Result					save						();
 		Result					save						(QString filename);
-		Result					load						(QString filename);
+		Result					load						(QString filename, const EntityDatabase& entity_db);
 
 		// Properties
 		QString					get_filename				();
@@ -67,6 +73,7 @@ namespace LTTPMapTracker
 		SchemaRegionPtr			create_region				();
 		SchemaRulePtr			create_rule					();
 		void					set_dirty					();
+		void					clear_rule_programs			();
 
 		struct Internal;
 		const std::unique_ptr<Internal> m_internal;
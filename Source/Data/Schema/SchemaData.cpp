@@ -1,5 +1,6 @@
 // Project includes
 #include "Data/Schema/SchemaData.h"
+#include "Data/Database/EntityDatabase.h"
 #include "Data/Schema/Schema.h"
 #include "Utility/JSON.h"
 #include "Utility/Result.h"
@@ -67,6 +68,15 @@ namespace LTTPMapTracker
 	// Rule
 	//================================================================================
 
+	SchemaRuleEntry::SchemaRuleEntry()
+		: m_type(SchemaRuleType::ProgressItem)
+		, m_id(-1)
+		, m_operator(SchemaRuleOperator::Or)
+		, m_brackets_open(0)
+		, m_brackets_close(0)
+	{
+	}
+
 	void SchemaRuleEntry::serialise(QJsonObject& json) const
 	{
 		json["Type"] = EnumReflection<SchemaRuleType>::info(m_type).m_type_name;
@@ -76,7 +86,7 @@ namespace LTTPMapTracker
 		json["Operator"] = EnumReflection<SchemaRuleOperator>::info(m_operator).m_type_name;
 	}
 
-	Result SchemaRuleEntry::deserialise(const QJsonObject& json, int /*version*/)
+	Result SchemaRuleEntry::deserialise(const QJsonObject& json, int /*version*/, const EntityDatabase& entity_db)
 	{
 		Result result;
 
@@ -94,9 +104,43 @@ namespace LTTPMapTracker
 		result << json_read(json, "BracketsOpen", m_brackets_open, 0);
 		result << json_read(json, "BracketsClose", m_brackets_close, 0);
 
+		resolve(entity_db);
+
 		return result;
 	}
 
+	void SchemaRuleEntry::resolve(const EntityDatabase& entity_db)
+	{
+		m_id = -1;
+
+		switch (m_type)
+		{
+		case SchemaRuleType::ProgressItem:
+		case SchemaRuleType::ProgressLocation:
+			{
+				auto entity = entity_db.get_entity(m_value);
+				if (entity != nullptr)
+				{
+					m_id = entity->m_id;
+				}
+			}
+			break;
+
+		case SchemaRuleType::ProgressSpecial:
+			{
+				auto info = EnumReflection<SchemaRuleTypeProgressSpecial>::info(m_value);
+				if (info != nullptr)
+				{
+					m_id = (int)info->m_type;
+				}
+			}
+			break;
+
+		default:
+			break;
+		}
+	}
+
 	//--------------------------------------------------------------------------------
 
 	void SchemaRuleData::serialise(QJsonObject& json) const
@@ -113,7 +157,7 @@ namespace LTTPMapTracker
 		json["RuleEntries"] = json_entries;
 	}
 
-	Result SchemaRuleData::deserialise(const QJsonObject& json, int version, Schema& /*schema*/)
+	Result SchemaRuleData::deserialise(const QJsonObject& json, int version, Schema& /*schema*/, const EntityDatabase& entity_db)
 	{
 		Result result;
 
@@ -126,7 +170,7 @@ namespace LTTPMapTracker
 		for (auto jval_entry : json_entries)
 		{
 			SchemaRuleEntry entry;
-			result << entry.deserialise(jval_entry.toObject(), version);
+			result << entry.deserialise(jval_entry.toObject(), version, entity_db);
 			m_entries << entry;
 		}
 
@@ -141,8 +185,6 @@ namespace LTTPMapTracker
 
 	SchemaRegionData::SchemaRegionData()
 		: m_color(255, 255, 255)
-		, m_accessible(false)
-		, m_accessible_cached(false)
 	{
 	}
 
@@ -12,6 +12,12 @@
 #include <QVariant>
 #include <QVector>
 
+// Forward declarations
+namespace LTTPMapTracker
+{
+	class EntityDatabase;
+}
+
 
 namespace LTTPMapTracker
 {
@@ -51,16 +57,21 @@ namespace LTTPMapTracker
 		And
 	};
 
+	// m_id is m_value resolved by resolve(): the entity id for ProgressItem/ProgressLocation,
+	// the SchemaRuleTypeProgressSpecial for ProgressSpecial, and -1 otherwise or if unknown.
 	struct SchemaRuleEntry
 	{
 		SchemaRuleType		m_type;
 		QString				m_value;
+		int					m_id;
 		SchemaRuleOperator	m_operator;
 		int					m_brackets_open;
 		int					m_brackets_close;
 
-		void	serialise	(QJsonObject& json) const;
-		Result	deserialise	(const QJsonObject& json, int version);
+				SchemaRuleEntry	();
+		void	serialise		(QJsonObject& json) const;
+		Result	deserialise		(const QJsonObject& json, int version, const EntityDatabase& entity_db);
+		void	resolve			(const EntityDatabase& entity_db);
 	};
 
 	struct SchemaRuleData
@@ -69,8 +80,10 @@ namespace LTTPMapTracker
 		QString						m_name;
 		QVector<SchemaRuleEntry>	m_entries;
 
+		mutable SchemaRuleProgramCPtr m_program;
+
 		void	serialise		(QJsonObject& json) const;
-		Result	deserialise		(const QJsonObject& json, int version, Schema& schema);
+		Result	deserialise		(const QJsonObject& json, int version, Schema& schema, const EntityDatabase& entity_db);
 	};
 
 	class SchemaRule : public SerializableDataWrapper<SchemaRuleData> {};
@@ -85,9 +98,6 @@ namespace LTTPMapTracker
 		QColor		  m_color;
 		SchemaRulePtr m_rule;
 
-		mutable bool  m_accessible;
-		mutable bool  m_accessible_cached;
-
 				SchemaRegionData	();
 		void	serialise			(QJsonObject& json) const;
 		Result	deserialise			(const QJsonObject& json, int version, Schema& schema);
@@ -0,0 +1,206 @@
+// Project includes
+#include "Data/Schema/SchemaRuleProgram.h"
+#include "Data/Schema/Schema.h"
+
+
+namespace LTTPMapTracker
+{
+	//================================================================================
+	// Utility
+	//================================================================================
+
+	namespace
+	{
+		struct ExpressionNode
+		{
+			SchemaRuleOperator						 m_operator;
+			int										 m_entry;
+			QVector<std::shared_ptr<ExpressionNode>> m_children;
+			std::weak_ptr<ExpressionNode>			 m_parent;
+
+			ExpressionNode() : m_operator(SchemaRuleOperator::Or), m_entry(-1) {}
+		};
+
+		SchemaRuleProgramEntry resolve_entry(const Schema& schema, const SchemaRuleEntry& entry)
+		{
+			SchemaRuleProgramEntry program_entry;
+			program_entry.m_type = entry.m_type;
+
+			switch (entry.m_type)
+			{
+			case SchemaRuleType::ProgressItem:
+			case SchemaRuleType::ProgressLocation:
+				if (entry.m_id != -1)
+				{
+					program_entry.m_entity = entry.m_id;
+				}
+				else
+				{
+					program_entry.m_type = SchemaRuleType::Inaccessible;
+				}
+				break;
+
+			case SchemaRuleType::ProgressSpecial:
+				if (entry.m_id != -1)
+				{
+					program_entry.m_special = (SchemaRuleTypeProgressSpecial)entry.m_id;
+				}
+				else
+				{
+					program_entry.m_type = SchemaRuleType::Inaccessible;
+				}
+				break;
+
+			case SchemaRuleType::SchemaRule:
+				program_entry.m_rule = schema.rules().find(entry.m_value);
+				break;
+
+			case SchemaRuleType::SchemaItem:
+				program_entry.m_item = schema.items().find(entry.m_value);
+				break;
+
+			case SchemaRuleType::SchemaRegion:
+				program_entry.m_region = schema.regions().find(entry.m_value);
+				break;
+
+			default:
+				break;
+			}
+
+			return program_entry;
+		}
+
+		void emit_node(SchemaRuleProgram& program, const ExpressionNode& node)
+		{
+			if (node.m_entry != -1)
+			{
+				program.m_instructions << SchemaRuleInstruction { SchemaRuleOpcode::Entry, node.m_entry };
+			}
+			else if (node.m_children.isEmpty())
+			{
+				program.m_instructions << SchemaRuleInstruction { SchemaRuleOpcode::True, 0 };
+			}
+			else
+			{
+				emit_node(program, *node.m_children[0]);
+
+				if (node.m_children.size() == 2)
+				{
+					int jump = program.m_instructions.size();
+					program.m_instructions << SchemaRuleInstruction { node.m_operator == SchemaRuleOperator::Or ? SchemaRuleOpcode::JumpIfTrue : SchemaRuleOpcode::JumpIfFalse, 0 };
+
+					emit_node(program, *node.m_children[1]);
+
+					program.m_instructions[jump].m_operand = program.m_instructions.size();
+				}
+			}
+		}
+	}
+
+
+
+	//================================================================================
+	// Construction
+	//================================================================================
+
+	SchemaRuleProgramEntry::SchemaRuleProgramEntry()
+		: m_type(SchemaRuleType::Inaccessible)
+		, m_entity(-1)
+		, m_special(SchemaRuleTypeProgressSpecial::Pendant1)
+	{
+	}
+
+	SchemaRuleProgram::SchemaRuleProgram()
+		: m_valid(true)
+	{
+	}
+
+
+
+	//================================================================================
+	// Utility
+	//================================================================================
+
+	SchemaRuleProgramCPtr compile_rule_program(const Schema& schema, const SchemaRuleData& rule)
+	{
+		auto program = std::make_shared<SchemaRuleProgram>();
+
+		// Build an expression tree.
+		auto root = std::make_shared<ExpressionNode>();
+		auto node = root;
+
+		auto& entries = rule.m_entries;
+		for (int entry_index = 0; entry_index < entries.size() && program->m_valid; ++entry_index)
+		{
+			auto& entry = entries[entry_index];
+
+			for (int i = 0; i < entry.m_brackets_open + 1; ++i)
+			{
+				if (node->m_children.size() == 2)
+				{
+					auto proxy_node = std::make_shared<ExpressionNode>();
+					proxy_node->m_operator = entries[entry_index - 1].m_operator;
+
+					auto parent = node->m_parent.lock();
+					if (parent != nullptr)
+					{
+						parent->m_children.removeOne(node);
+						parent->m_children << proxy_node;
+					}
+
+					proxy_node->m_parent = node->m_parent;
+					node->m_parent = proxy_node;
+					proxy_node->m_children << node;
+
+					if (node == root)
+					{
+						root = proxy_node;
+					}
+
+					node = proxy_node;
+				}
+
+				auto new_node = std::make_shared<ExpressionNode>();
+				node->m_children << new_node;
+				new_node->m_parent = node;
+				node = new_node;
+			}
+
+			node->m_entry = program->m_entries.size();
+			program->m_entries << resolve_entry(schema, entry);
+
+			for (int i = 0; i < entry.m_brackets_close && node != nullptr; ++i)
+			{
+				node = node->m_parent.lock();
+			}
+
+			// Unbalanced brackets never match.
+			auto parent = (node != nullptr ? node->m_parent.lock() : nullptr);
+			if (parent == nullptr)
+			{
+				program->m_valid = false;
+				break;
+			}
+
+			if (parent->m_children.size() == 1)
+			{
+				parent->m_operator = entry.m_operator;
+			}
+
+			node = parent;
+		}
+
+		// Flatten the tree.
+		if (program->m_valid)
+		{
+			emit_node(*program, *root);
+		}
+		else
+		{
+			program->m_instructions.clear();
+			program->m_entries.clear();
+		}
+
+		return program;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,71 @@
+#ifndef SCHEMA_RULE_PROGRAM_H
+#define SCHEMA_RULE_PROGRAM_H
+
+// Project includes
+#include "Data/Schema/SchemaData.h"
+
+// Qt includes
+#include <QVector>
+
+// Stdlib includes
+#include <memory>
+
+
+namespace LTTPMapTracker
+{
+	// Types
+	//--------------------------------------------------------------------------------
+
+	enum class SchemaRuleOpcode
+	{
+		Entry,
+		True,
+		JumpIfTrue,
+		JumpIfFalse
+	};
+
+	struct SchemaRuleInstruction
+	{
+		SchemaRuleOpcode	m_opcode;
+		int					m_operand;
+	};
+
+	struct SchemaRuleProgramEntry
+	{
+		SchemaRuleType						m_type;
+		int									m_entity;
+		SchemaRuleTypeProgressSpecial		m_special;
+		std::weak_ptr<const SchemaRule>		m_rule;
+		std::weak_ptr<const SchemaItem>		m_item;
+		std::weak_ptr<const SchemaRegion>	m_region;
+
+		SchemaRuleProgramEntry();
+	};
+
+
+	// Schema Rule Program
+	//--------------------------------------------------------------------------------
+
+	// A rule flattened into straight-line code. Entries leave their result in a single
+	// register; jumps skip the right hand side of an And/Or once its outcome is known.
+	// Progress entries take the ids their rule entries resolved at load; schema entries are
+	// resolved to the referenced rule, item or region at compile time. Anything unresolved
+	// never matches.
+
+	struct SchemaRuleProgram
+	{
+		QVector<SchemaRuleInstruction>	m_instructions;
+		QVector<SchemaRuleProgramEntry>	m_entries;
+		bool							m_valid;
+
+		SchemaRuleProgram();
+	};
+
+
+	// Utility
+	//--------------------------------------------------------------------------------
+
+	SchemaRuleProgramCPtr	compile_rule_program	(const Schema& schema, const SchemaRuleData& rule);
+}
+
+#endif
\ No newline at end of file
@@ -20,6 +20,9 @@ namespace LTTPMapTracker
 	using SchemaRuleCPtr = std::shared_ptr<const SchemaRule>;
 	struct SchemaRuleEntry;
 
+	struct SchemaRuleProgram;
+	using SchemaRuleProgramCPtr = std::shared_ptr<const SchemaRuleProgram>;
+
 	class SchemaRegion;
 	using SchemaRegionPtr = std::shared_ptr<SchemaRegion>;
 	using SchemaRegionCPtr = std::shared_ptr<const SchemaRegion>;
@@ -5,6 +5,7 @@
 namespace LTTPMapTracker
 {
 	class DataModel;
+	class MapMarkerCache;
 	class Settings;
 }
 
@@ -19,6 +20,8 @@ namespace LTTPMapTracker
 
 		virtual DataModel&			get_data_model	()			= 0;
 		virtual const DataModel&	get_data_model	()	const	= 0;
+
+		virtual MapMarkerCache&		get_marker_cache()			= 0;
 	};
 }
 
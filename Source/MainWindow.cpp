@@ -1,6 +1,7 @@
 // Project includes
 #include "MainWindow.h"
 #include "UI/ConfigurationWidget/ConfigurationWidget.h"
+#include "UI/MapWidget/Items/Common/MapMarkerCache.h"
 #include "UI/MapWidget/Items/MapSceneItemSchemaItem.h"
 #include "UI/MapWidget/MapScene.h"
 #include "UI/MapWidget/MapWidget.h"
@@ -48,6 +49,7 @@ namespace LTTPMapTracker
 			virtual const Settings&			get_settings	()	const	override { return m_internal.m_settings;	}
 			virtual DataModel&				get_data_model	()			override { return m_internal.m_data_model;	}
 			virtual const DataModel&		get_data_model	()	const	override { return m_internal.m_data_model;	}
+			virtual MapMarkerCache&			get_marker_cache()			override { return m_internal.m_marker_cache;	}
 
 		private:
 			Internal& m_internal;
@@ -58,6 +60,7 @@ namespace LTTPMapTracker
 		EditorInterfaceImpl		m_editor_interface;
 		Settings				m_settings;
 		DataModel				m_data_model;
+		MapMarkerCache			m_marker_cache;
 		WidgetStateManager		m_widget_state_manager;
 		WindowManagerPtr		m_window_manager;
 
@@ -385,7 +388,7 @@ namespace LTTPMapTracker
 		}
 
 		auto schema = std::make_shared<Schema>();
-		auto load_result = schema->load(filename);
+		auto load_result = schema->load(filename, m_internal->m_data_model.get_entity_db());
 		report_result(load_result, this, "Load Result");
 
 		if (!load_result)
@@ -2,20 +2,10 @@
 #define PCH_H
 
 // Project includes
-#include "Utility/ModelData/ModelData.h"
-#include "Utility/DataContainer.h"
-#include "Utility/DataWrapper.h"
-#include "Utility/EnumReflection.h"
-#include "Utility/File.h"
-#include "Utility/JSON.h"
-#include "Utility/Result.h"
+#include "CorePCH.h"
+#include "Utility/ResultDialog.h"
 
 // Qt includes
-#include <QtCore>
 #include <QWidget>
 
-// Stdlib includes
-#include <functional>
-#include <memory>
-
 #endif
\ No newline at end of file
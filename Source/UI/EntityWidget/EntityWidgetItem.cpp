@@ -21,6 +21,7 @@ namespace LTTPMapTracker
 		{
 			EntityWidgetItemData m_data;
 			QPixmap				 m_pixmap;
+			QPixmap				 m_highlight_pixmap;
 		};
 
 		QVector<Entry>	m_entries;
@@ -46,6 +47,7 @@ namespace LTTPMapTracker
 			Internal::Entry entry;
 			entry.m_data = data;
 			entry.m_pixmap = create_pixmap(data);
+			entry.m_highlight_pixmap = create_highlight_pixmap(entry.m_pixmap);
 			m_internal->m_entries << entry;
 		}
 
@@ -109,8 +111,16 @@ namespace LTTPMapTracker
 
 	void EntityWidgetItem::set_data(int index, const EntityWidgetItemData& data)
 	{
-		m_internal->m_entries[index].m_data = data;
-		m_internal->m_entries[index].m_pixmap = create_pixmap(data);
+		auto& entry = m_internal->m_entries[index];
+		entry.m_data = data;
+		entry.m_pixmap = create_pixmap(data);
+		entry.m_highlight_pixmap = create_highlight_pixmap(entry.m_pixmap);
+
+		if (index == m_internal->m_index)
+		{
+			setPixmap(entry.m_pixmap);
+		}
+
 		update();
 	}
 
@@ -126,14 +136,7 @@ namespace LTTPMapTracker
 	
 		if ((option->state & QStyle::State_MouseOver) && !entry.m_data.m_static)
 		{
-			auto pixmap = this->pixmap();
-
-			QPainter pixmap_painter(&pixmap);
-			pixmap_painter.setCompositionMode(QPainter::CompositionMode_SourceAtop);
-			pixmap_painter.fillRect(pixmap.rect(), QColor(255, 255, 0, 128));
-
-			painter->drawPixmap(pixmap.rect(), pixmap);
-
+			painter->drawPixmap(entry.m_highlight_pixmap.rect(), entry.m_highlight_pixmap);
 			return;
 		}
 
@@ -208,4 +211,16 @@ namespace LTTPMapTracker
 
 		return pixmap;
 	}
+
+	QPixmap EntityWidgetItem::create_highlight_pixmap(const QPixmap& pixmap) const
+	{
+		auto highlight_pixmap = pixmap;
+
+		QPainter painter(&highlight_pixmap);
+		painter.setCompositionMode(QPainter::CompositionMode_SourceAtop);
+		painter.fillRect(highlight_pixmap.rect(), QColor(255, 255, 0, 128));
+		painter.end();
+
+		return highlight_pixmap;
+	}
 }
\ No newline at end of file
@@ -79,6 +79,7 @@ namespace LTTPMapTracker
 	private:
 		// Helpers
 		QPixmap						create_pixmap			(const EntityWidgetItemData& data)												const;
+		QPixmap						create_highlight_pixmap	(const QPixmap& pixmap)															const;
 
 		struct Internal;
 		const std::unique_ptr<Internal> m_internal;
@@ -0,0 +1,174 @@
+// Project includes
+#include "UI/MapWidget/Items/Common/MapMarkerCache.h"
+
+// Qt includes
+#include <QCache>
+#include <QFont>
+#include <QPainter>
+
+
+namespace LTTPMapTracker
+{
+	//================================================================================
+	// Map Marker Key
+	//================================================================================
+
+	MapMarkerKey::MapMarkerKey()
+		: m_size(0)
+		, m_color(0)
+		, m_location(nullptr)
+		, m_entrance(nullptr)
+		, m_requirement(nullptr)
+	{
+	}
+
+	bool MapMarkerKey::operator==(const MapMarkerKey& other) const
+	{
+		return (m_size == other.m_size &&
+				m_color == other.m_color &&
+				m_location == other.m_location &&
+				m_entrance == other.m_entrance &&
+				m_requirement == other.m_requirement);
+	}
+
+	uint qHash(const MapMarkerKey& key, uint seed)
+	{
+		seed = ::qHash(key.m_size, seed) ^ (seed << 1);
+		seed = ::qHash(key.m_color, seed) ^ (seed << 1);
+		seed = ::qHash(key.m_location, seed) ^ (seed << 1);
+		seed = ::qHash(key.m_entrance, seed) ^ (seed << 1);
+		seed = ::qHash(key.m_requirement, seed) ^ (seed << 1);
+		return seed;
+	}
+
+
+
+	//================================================================================
+	// Internal
+	//================================================================================
+
+	struct MapMarkerCache::Internal
+	{
+		QCache<MapMarkerKey, QPixmap>	m_pixmaps;
+		quint64							m_num_hits;
+		quint64							m_num_misses;
+
+		Internal(int capacity)
+			: m_pixmaps(capacity)
+			, m_num_hits(0)
+			, m_num_misses(0)
+		{
+		}
+
+		QPixmap render(const MapMarkerKey& key) const
+		{
+			auto color = QColor::fromRgb(key.m_color);
+			int size = key.m_size;
+			int border_size = (float)size * 0.125f;
+			auto rect = QRect(0, 0, size, size);
+
+			QPixmap pixmap(size, size);
+			QPainter painter(&pixmap);
+
+			painter.setBrush(color.lighter());
+			painter.drawRect(rect);
+			painter.setBrush(color);
+			painter.drawRect(rect.adjusted(border_size, border_size, -border_size, -border_size));
+
+			if (key.m_location != nullptr)
+			{
+				painter.drawPixmap(rect.adjusted(border_size, border_size, -border_size, -border_size), key.m_location->m_image);
+
+				if (key.m_entrance != nullptr)
+				{
+					auto entrance_pixmap = key.m_entrance->m_image;
+					painter.drawPixmap(rect.bottomRight() - QPoint(pixmap.width() - 1, entrance_pixmap.height() - 1), entrance_pixmap);
+				}
+			}
+			else
+			{
+				QFont font;
+				font.setBold(true);
+				font.setPixelSize((float)size * 0.8f);
+				painter.setFont(font);
+				painter.setBrush(QColor(0, 0, 0));
+				painter.drawText(rect.adjusted(1, 0, 0, 0), "?", QTextOption(Qt::AlignCenter));
+			}
+
+			if (key.m_requirement != nullptr)
+			{
+				painter.drawPixmap(rect.bottomLeft() - QPoint(0, key.m_requirement->m_image.height() - 1), key.m_requirement->m_image);
+			}
+
+			return pixmap;
+		}
+	};
+
+
+
+	//================================================================================
+	// Construction & Destruction
+	//================================================================================
+
+	MapMarkerCache::MapMarkerCache(int capacity)
+		: m_internal(std::make_unique<Internal>(capacity))
+	{
+	}
+
+	MapMarkerCache::~MapMarkerCache()
+	{
+	}
+
+
+
+	//================================================================================
+	// Pixmaps
+	//================================================================================
+
+	QPixmap MapMarkerCache::get_pixmap(const MapMarkerKey& key)
+	{
+		auto pixmap = m_internal->m_pixmaps.object(key);
+		if (pixmap != nullptr)
+		{
+			++m_internal->m_num_hits;
+			return *pixmap;
+		}
+
+		++m_internal->m_num_misses;
+
+		auto rendered = m_internal->render(key);
+		m_internal->m_pixmaps.insert(key, new QPixmap(rendered));
+		return rendered;
+	}
+
+	void MapMarkerCache::clear()
+	{
+		m_internal->m_pixmaps.clear();
+	}
+
+
+
+	//================================================================================
+	// Statistics
+	//================================================================================
+
+	int MapMarkerCache::get_size() const
+	{
+		return m_internal->m_pixmaps.count();
+	}
+
+	int MapMarkerCache::get_capacity() const
+	{
+		return m_internal->m_pixmaps.maxCost();
+	}
+
+	quint64 MapMarkerCache::get_num_hits() const
+	{
+		return m_internal->m_num_hits;
+	}
+
+	quint64 MapMarkerCache::get_num_misses() const
+	{
+		return m_internal->m_num_misses;
+	}
+}
\ No newline at end of file
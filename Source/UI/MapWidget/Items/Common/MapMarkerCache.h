@@ -0,0 +1,68 @@
+#ifndef MAP_MARKER_CACHE_H
+#define MAP_MARKER_CACHE_H
+
+// Project includes
+#include "Data/Database/EntityDatabase.h"
+
+// Qt includes
+#include <QColor>
+#include <QPixmap>
+
+// Stdlib includes
+#include <memory>
+
+
+namespace LTTPMapTracker
+{
+	// Map Marker Key
+	//--------------------------------------------------------------------------------
+
+	// Everything an instance item marker is drawn from. Entities are referenced by address;
+	// they live as long as the data model.
+	struct MapMarkerKey
+	{
+		int				m_size;
+		QRgb			m_color;
+		const Entity*	m_location;
+		const Entity*	m_entrance;
+		const Entity*	m_requirement;
+
+		MapMarkerKey();
+
+		bool operator==(const MapMarkerKey& other) const;
+	};
+
+	uint qHash(const MapMarkerKey& key, uint seed = 0);
+
+
+	// Map Marker Cache
+	//--------------------------------------------------------------------------------
+
+	// Rendered marker pixmaps, shared by every scene. Only a handful of combinations occur
+	// in practice, so identical markers share one pixmap. The least recently used entries
+	// are dropped once the cache is full.
+
+	class MapMarkerCache
+	{
+	public:
+		// Construction & Destruction
+						MapMarkerCache	(int capacity = 256);
+						~MapMarkerCache	();
+
+		// Pixmaps
+		QPixmap			get_pixmap		(const MapMarkerKey& key);
+		void			clear			();
+
+		// Statistics
+		int				get_size		() const;
+		int				get_capacity	() const;
+		quint64			get_num_hits	() const;
+		quint64			get_num_misses	() const;
+
+	private:
+		struct Internal;
+		const std::unique_ptr<Internal> m_internal;
+	};
+}
+
+#endif
\ No newline at end of file
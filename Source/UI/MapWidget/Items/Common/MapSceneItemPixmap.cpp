@@ -1,9 +1,9 @@
 // Project includes
 #include "UI/MapWidget/Items/Common/MapSceneItemPixmap.h"
+#include "UI/MapWidget/MapScene.h"
 
 // Qt includes
 #include <QApplication>
-#include <QGraphicsScene>
 
 
 namespace LTTPMapTracker
@@ -61,30 +61,9 @@ namespace LTTPMapTracker
 		}
 		
 		// Maintain Z values based on selection order.
-		if (change == QGraphicsItem::ItemSelectedChange)
+		if (change == QGraphicsItem::ItemSelectedChange && value.toBool())
 		{
-			if (value.toBool())
-			{
-				auto items = scene()->items();
-				
-				items.erase(std::remove_if(items.begin(), items.end(), [] (QGraphicsItem* item)
-				{
-					return (item->zValue() < 0.0f);
-				}));
-
-				qSort(items.begin(), items.end(), [] (QGraphicsItem* a, QGraphicsItem* b)
-				{
-					return (a->zValue() < b->zValue());
-				});
-
-				items.removeOne(this);
-				items.push_back(this);
-
-				for (int i = 0; i < items.size(); ++i)
-				{
-					items[i]->setZValue(i);
-				}
-			}
+			static_cast<MapScene*>(scene())->raise_item(*this);
 		}
 
 		return value;
@@ -19,11 +19,13 @@ namespace LTTPMapTracker
 
 	struct MapSceneItemConnectionItem::Internal
 	{
+		EditorInterface&		m_editor_interface;
 		InstancePtr				m_instance;
 		InstanceConnectionPtr	m_connection;
 
-		Internal(InstancePtr instance, InstanceConnectionPtr connection)
-			: m_instance(instance)
+		Internal(EditorInterface& editor_interface, InstancePtr instance, InstanceConnectionPtr connection)
+			: m_editor_interface(editor_interface)
+			, m_instance(instance)
 			, m_connection(connection)
 		{
 		}
@@ -37,16 +39,10 @@ namespace LTTPMapTracker
 
 	MapSceneItemConnectionItem::MapSceneItemConnectionItem(EditorInterface& editor_interface, InstancePtr instance, InstanceConnectionPtr connection, QGraphicsItem* parent)
 		: QGraphicsLineItem(parent)
-		, m_internal(std::make_unique<Internal>(instance, connection))
+		, m_internal(std::make_unique<Internal>(editor_interface, instance, connection))
 	{
 		// Properties.
-		QPen pen;
-		pen.setWidthF(editor_interface.get_settings().get().m_map_connection_thickness);
-		pen.setCosmetic(true);
-		pen.setCapStyle(Qt::RoundCap);
-		pen.setColor(editor_interface.get_settings().get().m_map_connection_color);
-		setPen(pen);
-		
+		cache_style();
 		setBoundingRegionGranularity(0.2f);
 		setZValue(-1.0f);
 
@@ -96,4 +92,22 @@ namespace LTTPMapTracker
 	{
 		return m_internal->m_connection;
 	}
+
+
+
+	//================================================================================
+	// Caching
+	//================================================================================
+
+	void MapSceneItemConnectionItem::cache_style()
+	{
+		auto& settings = m_internal->m_editor_interface.get_settings().get();
+
+		QPen pen;
+		pen.setWidthF(settings.m_map_connection_thickness);
+		pen.setCosmetic(true);
+		pen.setCapStyle(Qt::RoundCap);
+		pen.setColor(settings.m_map_connection_color);
+		setPen(pen);
+	}
 }
\ No newline at end of file
@@ -35,6 +35,9 @@ namespace LTTPMapTracker
 		InstanceConnectionPtr	get_connection				();
 		InstanceConnectionCPtr	get_connection				() const;
 
+		// Caching
+		void					cache_style					();
+
 	private:
 		struct Internal;
 		const std::unique_ptr<Internal> m_internal;
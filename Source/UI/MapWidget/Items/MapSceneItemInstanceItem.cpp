@@ -1,5 +1,6 @@
 // Project includes
 #include "UI/MapWidget/Items/MapSceneItemInstanceItem.h"
+#include "UI/MapWidget/Items/Common/MapMarkerCache.h"
 #include "Data/Database/EntityDatabase.h"
 #include "Data/Instance/Instance.h"
 #include "Data/Instance/InstanceRuleParser.h"
@@ -9,7 +10,6 @@
 #include "EditorInterface.h"
 
 // Qt includes
-#include <QFont>
 #include <QGraphicsScene>
 #include <QGraphicsSceneMouseEvent>
 #include <QGraphicsView>
@@ -33,11 +33,15 @@ namespace LTTPMapTracker
 		InstanceItemPtr	 m_instance_item;
 
 		QColor			 m_color;
+		bool			 m_tooltip_cached;
+		quint64			 m_tooltip_epoch;
 
 		Internal(EditorInterface& editor_interface, InstancePtr instance, InstanceItemPtr instance_item)
 			: m_editor_interface(editor_interface)
 			, m_instance(instance)
 			, m_instance_item(instance_item)
+			, m_tooltip_cached(false)
+			, m_tooltip_epoch(0)
 		{
 		}
 	};
@@ -57,17 +61,9 @@ namespace LTTPMapTracker
 
 		// Properties.
 		setPos(instance_item->get().m_schema_item->get().m_position);
-		setOffset(-pixmap().width() * 0.5f, -pixmap().height() * 0.5f);
 		setFlags(QGraphicsItem::ItemIgnoresTransformations);
 		setShapeMode(QGraphicsPixmapItem::BoundingRectShape);
-
-		// Signals.
-		for (auto item : instance->items())
-		{
-			connect(item.get(), &InstanceItem::signal_modified, this, &MapSceneItemInstanceItem::cache);
-		}
-		
-		connect(instance.get(), &Instance::signal_accessibility_cached, this, &MapSceneItemInstanceItem::cache);
+		setAcceptHoverEvents(true);
 	}
 
 
@@ -104,6 +100,17 @@ namespace LTTPMapTracker
 		}
 	}
 
+	void MapSceneItemInstanceItem::hoverEnterEvent(QGraphicsSceneHoverEvent* event)
+	{
+		// Tooltips list which required items have been found, so progress made since they were built invalidates them too.
+		if (!m_internal->m_tooltip_cached || m_internal->m_tooltip_epoch != m_internal->m_instance->progress_epoch())
+		{
+			cache_tooltip();
+		}
+
+		MapSceneItemPixmap::hoverEnterEvent(event);
+	}
+
 
 
 	//================================================================================
@@ -123,67 +130,46 @@ namespace LTTPMapTracker
 
 
 	//================================================================================
-	// Helpers
+	// Caching
 	//================================================================================
 
 	void MapSceneItemInstanceItem::cache()
 	{
 		cache_color();
 		cache_pixmap();
-		cache_tooltip();
+		invalidate_tooltip();
 
 		setZValue(!m_internal->m_instance_item->get().m_cleared ? 1.0f : 0.0f);
 	}
 
-	void MapSceneItemInstanceItem::cache_pixmap()
-	{
-		auto& data = m_internal->m_instance_item->get();
 
-		auto color = m_internal->m_color;
-		color.setAlpha(255);
 
-		int size = m_internal->m_editor_interface.get_settings().get().m_map_item_size;
-		int border_size = (float)size * 0.125f;
-		auto rect = QRect(0, 0, size, size);
+	//================================================================================
+	// Helpers
+	//================================================================================
 
-		QPixmap pixmap(size, size);
-		QPainter painter(&pixmap);
+	void MapSceneItemInstanceItem::cache_pixmap()
+	{
+		auto& data = m_internal->m_instance_item->get();
+		auto& settings = m_internal->m_editor_interface.get_settings().get();
 
-		painter.setBrush(color.lighter());
-		painter.drawRect(rect);
-		painter.setBrush(color);
-		painter.drawRect(rect.adjusted(border_size, border_size, -border_size, -border_size));
+		MapMarkerKey key;
+		key.m_size = settings.m_map_item_size;
+		key.m_color = m_internal->m_color.rgb();
 
 		if (data.m_location != nullptr)
 		{
-			painter.drawPixmap(rect.adjusted(border_size, border_size, -border_size, -border_size), data.m_location->m_entity->m_image);
-
-			if (data.m_location_entrance != nullptr)
-			{
-				auto entrance_pixmap = data.m_location_entrance->m_image;
-				painter.drawPixmap(rect.bottomRight() - QPoint(pixmap.width() - 1, entrance_pixmap.height() - 1), entrance_pixmap);
-			}
-		}
-		else
-		{
-			QFont font;
-			font.setBold(true);
-			font.setPixelSize((float)size * 0.8f);
-			painter.setFont(font);
-			painter.setBrush(QColor(0, 0, 0));
-			painter.drawText(rect.adjusted(1, 0, 0, 0), "?", QTextOption(Qt::AlignCenter));
+			key.m_location = data.m_location->m_entity.get();
+			key.m_entrance = data.m_location_entrance.get();
 		}
 
 		if (!data.m_items.isEmpty())
 		{
-			auto entity = m_internal->m_editor_interface.get_data_model().get_entity_db().get_entity(m_internal->m_editor_interface.get_settings().get().m_map_item_entity_item_requirement);
-			if (entity != nullptr)
-			{
-				painter.drawPixmap(rect.bottomLeft() - QPoint(0, entity->m_image.height() - 1), entity->m_image);
-			}
+			key.m_requirement = m_internal->m_editor_interface.get_data_model().get_entity_db().get_entity(settings.m_map_item_entity_item_requirement).get();
 		}
 
-		setPixmap(pixmap);
+		setPixmap(m_internal->m_editor_interface.get_marker_cache().get_pixmap(key));
+		setOffset(-pixmap().width() * 0.5f, -pixmap().height() * 0.5f);
 	}
 
 	void MapSceneItemInstanceItem::cache_color()
@@ -191,47 +177,18 @@ namespace LTTPMapTracker
 		auto& settings = m_internal->m_editor_interface.get_settings().get();
 		auto color = settings.m_map_item_color_base;
 
-		auto& data = m_internal->m_instance_item->get();
-
-		if (!data.m_accessible)
-		{
-			color = settings.m_map_item_color_inaccessible;
-		}
-		else
+		switch (m_internal->m_instance->get_item_status(m_internal->m_instance_item))
 		{
-			bool requires_items = false;
-
-			if (!data.m_items.isEmpty())
-			{
-				requires_items = std::any_of(data.m_items.begin(), data.m_items.end(), [this] (ItemCPtr item)
-				{
-					return !m_internal->m_instance->progress_items().contains(item->m_entity);
-				});
-
-				if (requires_items)
-				{
-					color = settings.m_map_item_color_item_requirement;
-				}
-				else
-				{
-					color = settings.m_map_item_color_item_requirement_fulfilled;
-				}
-			}
-			
-			if (!requires_items && data.m_location != nullptr)
-			{
-				auto match_result = match_location_requirements(data.m_location->m_requirements, *m_internal->m_instance);
-
-				switch (match_result)
-				{
-				case LocationMatch::No: color = settings.m_map_item_color_location_requirement; break;
-				case LocationMatch::Maybe: color = settings.m_map_item_color_location; break;
-				case LocationMatch::Yes: color = settings.m_map_item_color_location_requirement_fulfilled; break;
-				}
-			}
+		case InstanceItemStatus::Inaccessible: color = settings.m_map_item_color_inaccessible; break;
+		case InstanceItemStatus::Accessible: break;
+		case InstanceItemStatus::ItemRequirement: color = settings.m_map_item_color_item_requirement; break;
+		case InstanceItemStatus::ItemRequirementFulfilled: color = settings.m_map_item_color_item_requirement_fulfilled; break;
+		case InstanceItemStatus::LocationRequirement: color = settings.m_map_item_color_location_requirement; break;
+		case InstanceItemStatus::Location: color = settings.m_map_item_color_location; break;
+		case InstanceItemStatus::LocationRequirementFulfilled: color = settings.m_map_item_color_location_requirement_fulfilled; break;
 		}
 
-		if (data.m_cleared)
+		if (m_internal->m_instance_item->get().m_cleared)
 		{
 			color.setAlphaF(settings.m_map_item_opacity_cleared);
 		}
@@ -255,5 +212,18 @@ namespace LTTPMapTracker
 		}
 
 		setToolTip(tooltip);
+		m_internal->m_tooltip_cached = true;
+		m_internal->m_tooltip_epoch = m_internal->m_instance->progress_epoch();
+	}
+
+	void MapSceneItemInstanceItem::invalidate_tooltip()
+	{
+		// Tooltips are rebuilt when next hovered, or straight away if already hovered.
+		m_internal->m_tooltip_cached = false;
+
+		if (isUnderMouse())
+		{
+			cache_tooltip();
+		}
 	}
 }
\ No newline at end of file
@@ -27,17 +27,21 @@ namespace LTTPMapTracker
 		// QGraphicsItem Interface
 		virtual void				paint							(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget) override;
 		virtual void				mousePressEvent					(QGraphicsSceneMouseEvent* event) override;
+		virtual void				hoverEnterEvent					(QGraphicsSceneHoverEvent* event) override;
 
 		// Accessors
 		InstanceItemPtr				get_instance_item				();
 		InstanceItemCPtr			get_instance_item				() const;
 
+		// Caching
+		void						cache							();
+
 	private:
 		// Helpers
-		void						cache							();
 		void						cache_pixmap					();
 		void						cache_color						();
 		void						cache_tooltip					();
+		void						invalidate_tooltip				();
 
 		struct Internal;
 		const std::unique_ptr<Internal> m_internal;
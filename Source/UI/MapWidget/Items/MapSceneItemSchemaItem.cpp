@@ -45,11 +45,10 @@ namespace LTTPMapTracker
 		, m_internal(std::make_unique<Internal>(editor_interface, schema_item))
 	{
 		// Create pixmap.
-		create_pixmap();
+		cache_pixmap();
 
 		// Properties.
 		setPos(schema_item->get().m_position);
-		setOffset(-pixmap().width() * 0.5f, -pixmap().height() * 0.5f);
 		setFlags(QGraphicsItem::ItemIsMovable | QGraphicsItem::ItemIsSelectable | QGraphicsItem::ItemIgnoresTransformations | QGraphicsItem::ItemSendsGeometryChanges);
 		setShapeMode(QGraphicsPixmapItem::BoundingRectShape);
 
@@ -125,7 +124,7 @@ namespace LTTPMapTracker
 	void MapSceneItemSchemaItem::slot_schema_item_modified()
 	{
 		m_internal->m_schema_item_sync = true;
-		create_pixmap();
+		cache_pixmap();
 		setPos(m_internal->m_schema_item->get().m_position);
 		m_internal->m_schema_item_sync = false;
 	}
@@ -133,10 +132,10 @@ namespace LTTPMapTracker
 
 
 	//================================================================================
-	// Helpers
+	// Caching
 	//================================================================================
 
-	void MapSceneItemSchemaItem::create_pixmap()
+	void MapSceneItemSchemaItem::cache_pixmap()
 	{
 		int size = m_internal->m_editor_interface.get_settings().get().m_map_item_size;
 		int border_size = (float)size * 0.125f;
@@ -163,5 +162,6 @@ namespace LTTPMapTracker
 		painter.setBrush(QColor(0, 0, 0));
 		painter.drawText(rect.adjusted(1, 0, 0, 0), "?", QTextOption(Qt::AlignCenter));
 		setPixmap(pixmap);
+		setOffset(-pixmap.width() * 0.5f, -pixmap.height() * 0.5f);
 	}
 }
\ No newline at end of file
@@ -34,14 +34,14 @@ namespace LTTPMapTracker
 		SchemaItemPtr				get_schema_item				();
 		SchemaItemCPtr				get_schema_item				() const;
 
+		// Caching
+		void						cache_pixmap				();
+
 	private slots:
 		// Schema Item Slots
 		void						slot_schema_item_modified	();
 
 	private:
-		// Helpers
-		void						create_pixmap				();
-
 		struct Internal;
 		const std::unique_ptr<Internal> m_internal;
 	};
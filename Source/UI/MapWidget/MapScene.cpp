@@ -51,18 +51,35 @@ namespace Utility
 
 namespace LTTPMapTracker
 {
+	//================================================================================
+	// Constants
+	//================================================================================
+
+	// Raised items are stacked above instance item markers, which sit at 0 and 1.
+	static const qreal s_raised_z_min = 2.0;
+	static const qreal s_raised_z_max = 1000000.0;
+
+
+
 	//================================================================================
 	// Internal
 	//================================================================================
 
 	struct MapScene::Internal
 	{
-		using SceneItemTypeMap = QMap<const QGraphicsItem*, MapSceneItemType>;
+		using SceneItemTypeMap = QHash<const QGraphicsItem*, MapSceneItemType>;
+		using SchemaItemIndex = QHash<const SchemaItem*, MapSceneItemSchemaItem*>;
+		using InstanceItemIndex = QHash<const InstanceItem*, MapSceneItemInstanceItem*>;
+		using ConnectionIndex = QHash<const InstanceConnection*, MapSceneItemConnectionItem*>;
 
 		EditorInterface&		m_editor_interface;
 		MapSceneType			m_type;
 		MapSceneItemBackground* m_bg_item;
 		SceneItemTypeMap		m_item_types;
+		SchemaItemIndex			m_schema_items;
+		InstanceItemIndex		m_instance_items;
+		ConnectionIndex			m_connection_items;
+		qreal					m_raised_z;
 
 		SchemaPtr				m_schema;
 		InstancePtr				m_instance;
@@ -71,8 +88,14 @@ namespace LTTPMapTracker
 			: m_editor_interface(editor_interface)
 			, m_type(type)
 			, m_bg_item()
+			, m_raised_z(s_raised_z_min)
 		{
 		}
+
+		bool is_on_map(SchemaItemCPtr schema_item) const
+		{
+			return (schema_item->get().m_map == EnumReflection<MapSceneType, MapSceneTypeInfo>::info(m_type).m_schema_item_map_type);
+		}
 	};
 
 
@@ -119,6 +142,41 @@ namespace LTTPMapTracker
 
 
 
+	//================================================================================
+	// Z Order
+	//================================================================================
+
+	void MapScene::raise_item(QGraphicsItem& item)
+	{
+		// Each raise takes the next Z value up. Once they run high, raised items are renumbered
+		// in their current order, which leaves everything else alone.
+		if (m_internal->m_raised_z >= s_raised_z_max)
+		{
+			auto scene_items = items();
+
+			scene_items.erase(std::remove_if(scene_items.begin(), scene_items.end(), [] (QGraphicsItem* scene_item)
+			{
+				return (scene_item->zValue() < s_raised_z_min);
+			}), scene_items.end());
+
+			std::stable_sort(scene_items.begin(), scene_items.end(), [] (QGraphicsItem* a, QGraphicsItem* b)
+			{
+				return (a->zValue() < b->zValue());
+			});
+
+			m_internal->m_raised_z = s_raised_z_min;
+
+			for (auto scene_item : scene_items)
+			{
+				scene_item->setZValue(++m_internal->m_raised_z);
+			}
+		}
+
+		item.setZValue(++m_internal->m_raised_z);
+	}
+
+
+
 	//================================================================================
 	// Schema
 	//================================================================================
@@ -129,11 +187,9 @@ namespace LTTPMapTracker
 
 		for (auto schema_item : schema->items().get())
 		{
-			if (schema_item->get().m_map == EnumReflection<MapSceneType, MapSceneTypeInfo>::info(m_internal->m_type).m_schema_item_map_type)
+			if (m_internal->is_on_map(schema_item))
 			{
-				auto scene_item = new MapSceneItemSchemaItem(m_internal->m_editor_interface, schema_item);
-				m_internal->m_item_types.insert(scene_item, MapSceneItemType::SchemaItem);
-				addItem(scene_item);
+				add_schema_item(schema_item);
 			}
 		}
 
@@ -150,9 +206,7 @@ namespace LTTPMapTracker
 		{
 			m_internal->m_schema->items().disconnect(this);
 
-			removeItem(m_internal->m_bg_item);
-			clear();
-			addItem(m_internal->m_bg_item);
+			clear_scene_items();
 
 			m_internal->m_schema = nullptr;
 		}
@@ -170,28 +224,31 @@ namespace LTTPMapTracker
 
 		for (auto instance_item : instance->items())
 		{
-			auto schema_item = instance_item->get().m_schema_item;
-			if (schema_item->get().m_map == EnumReflection<MapSceneType, MapSceneTypeInfo>::info(m_internal->m_type).m_schema_item_map_type)
+			if (m_internal->is_on_map(instance_item->get().m_schema_item))
 			{
-				auto scene_item = new MapSceneItemInstanceItem(m_internal->m_editor_interface, instance, instance_item);
-				m_internal->m_item_types.insert(scene_item, MapSceneItemType::InstanceItem);
-				addItem(scene_item);
+				add_instance_item(instance, instance_item);
+
+				// Each item's changes go to its own scene item only.
+				auto instance_item_ptr = instance_item.get();
+				connect(instance_item_ptr, &InstanceItem::signal_modified, this, [this, instance_item_ptr] ()
+				{
+					slot_instance_item_modified(instance_item_ptr);
+				});
 			}
 		}
 
 		for (auto connection : instance->connections().get())
 		{
-			auto schema_item = connection->get().m_items[0]->get().m_schema_item;
-			if (schema_item->get().m_map == EnumReflection<MapSceneType, MapSceneTypeInfo>::info(m_internal->m_type).m_schema_item_map_type)
+			if (m_internal->is_on_map(connection->get().m_items[0]->get().m_schema_item))
 			{
-				auto scene_item = new MapSceneItemConnectionItem(m_internal->m_editor_interface, instance, connection);
-				m_internal->m_item_types.insert(scene_item, MapSceneItemType::Connection);
-				addItem(scene_item);
+				add_connection_item(instance, connection);
 			}
 		}
 
 		connect(&instance->connections(), &InstanceConnections::signal_added, this, &MapScene::slot_instance_connection_added);
 		connect(&instance->connections(), &InstanceConnections::signal_to_be_removed, this, &MapScene::slot_instance_connection_to_be_removed);
+		connect(&instance->connections(), &InstanceConnections::signal_batch_changed, this, &MapScene::slot_instance_connections_batch_changed);
+		connect(instance.get(), &Instance::signal_accessibility_changed, this, &MapScene::slot_instance_accessibility_changed);
 
 		m_internal->m_instance = instance;
 	}
@@ -201,10 +258,14 @@ namespace LTTPMapTracker
 		if (m_internal->m_instance != nullptr)
 		{
 			m_internal->m_instance->connections().disconnect(this);
+			m_internal->m_instance->disconnect(this);
 
-			removeItem(m_internal->m_bg_item);
-			clear();
-			addItem(m_internal->m_bg_item);
+			for (auto instance_item : m_internal->m_instance->items())
+			{
+				instance_item->disconnect(this);
+			}
+
+			clear_scene_items();
 
 			m_internal->m_instance = nullptr;
 		}
@@ -218,6 +279,15 @@ namespace LTTPMapTracker
 
 	void MapScene::slot_settings_changed(const SettingsDiff& diff)
 	{
+		// Existing scene items are restyled in place.
+		if (diff.has_change(&SettingsData::m_map_item_size))
+		{
+			for (auto scene_item : m_internal->m_schema_items)
+			{
+				scene_item->cache_pixmap();
+			}
+		}
+
 		if (diff.has_change(&SettingsData::m_map_item_size) ||
 			diff.has_change(&SettingsData::m_map_item_opacity_cleared) ||
 			diff.has_change(&SettingsData::m_map_item_color_base) ||
@@ -225,17 +295,22 @@ namespace LTTPMapTracker
 			diff.has_change(&SettingsData::m_map_item_color_item_requirement) ||
 			diff.has_change(&SettingsData::m_map_item_color_item_requirement_fulfilled) ||
 			diff.has_change(&SettingsData::m_map_item_color_location) ||
-			diff.has_change(&SettingsData::m_map_connection_thickness) ||
-			diff.has_change(&SettingsData::m_map_connection_color))
+			diff.has_change(&SettingsData::m_map_item_color_location_requirement) ||
+			diff.has_change(&SettingsData::m_map_item_color_location_requirement_fulfilled) ||
+			diff.has_change(&SettingsData::m_map_item_entity_item_requirement))
 		{
-			if (m_internal->m_schema != nullptr)
+			for (auto scene_item : m_internal->m_instance_items)
 			{
-				set_schema(m_internal->m_schema);
+				scene_item->cache();
 			}
+		}
 
-			if (m_internal->m_instance != nullptr)
+		if (diff.has_change(&SettingsData::m_map_connection_thickness) ||
+			diff.has_change(&SettingsData::m_map_connection_color))
+		{
+			for (auto scene_item : m_internal->m_connection_items)
 			{
-				set_instance(m_internal->m_instance);
+				scene_item->cache_style();
 			}
 		}
 	}
@@ -250,86 +325,165 @@ namespace LTTPMapTracker
 	{
 		auto schema_item = m_internal->m_schema->items()[index];
 
-		if (schema_item->get().m_map == EnumReflection<MapSceneType, MapSceneTypeInfo>::info(m_internal->m_type).m_schema_item_map_type)
+		if (m_internal->is_on_map(schema_item))
 		{
-			auto scene_item = new MapSceneItemSchemaItem(m_internal->m_editor_interface, schema_item);
-			m_internal->m_item_types.insert(scene_item, MapSceneItemType::SchemaItem);
-			addItem(scene_item);
+			add_schema_item(schema_item);
 		}
 	}
 
 	void MapScene::slot_schema_item_to_be_removed(int index)
 	{
-		auto schema_item = m_internal->m_schema->items()[index];
-		auto scene_items = this->items();
-
-		auto it = std::find_if(scene_items.begin(), scene_items.end(), [this, schema_item] (QGraphicsItem* scene_item)
-		{
-			return (get_item_type(*scene_item) == MapSceneItemType::SchemaItem &&
-					static_cast<MapSceneItemSchemaItem*>(scene_item)->get_schema_item() == schema_item);
-		});
-
-		if (it != scene_items.end())
+		auto scene_item = m_internal->m_schema_items.value(m_internal->m_schema->items()[index].get());
+		if (scene_item != nullptr)
 		{
-			removeItem(*it);
-			delete_later(*it);
+			remove_scene_item(scene_item);
 		}
 	}
 
 	void MapScene::slot_schema_item_modified(int index)
 	{
 		auto schema_item = m_internal->m_schema->items()[index];
-		auto scene_items = this->items();
+		auto scene_item = m_internal->m_schema_items.value(schema_item.get());
 
-		auto it = std::find_if(scene_items.begin(), scene_items.end(), [this, schema_item] (QGraphicsItem* scene_item)
+		if (scene_item != nullptr && !m_internal->is_on_map(schema_item))
 		{
-			return (get_item_type(*scene_item) == MapSceneItemType::SchemaItem &&
-					static_cast<MapSceneItemSchemaItem*>(scene_item)->get_schema_item() == schema_item);
-		});
-
-		if (it != scene_items.end() && schema_item->get().m_map != EnumReflection<MapSceneType, MapSceneTypeInfo>::info(m_internal->m_type).m_schema_item_map_type)
-		{
-			removeItem(*it);
-			delete_later(*it);
+			remove_scene_item(scene_item);
 		}
 
-		if (it == scene_items.end() && schema_item->get().m_map == EnumReflection<MapSceneType, MapSceneTypeInfo>::info(m_internal->m_type).m_schema_item_map_type)
+		if (scene_item == nullptr && m_internal->is_on_map(schema_item))
 		{
-			auto scene_item = new MapSceneItemSchemaItem(m_internal->m_editor_interface, schema_item);
-			m_internal->m_item_types.insert(scene_item, MapSceneItemType::SchemaItem);
-			addItem(scene_item);
+			add_schema_item(schema_item);
 		}
 	}
 
 	void MapScene::slot_instance_connection_added(int index)
 	{
 		auto connection = m_internal->m_instance->connections()[index];
-		auto scene_items = this->items();
 
-		auto map = connection->get().m_items[0]->get().m_schema_item->get().m_map;
-		if (map == EnumReflection<MapSceneType, MapSceneTypeInfo>::info(m_internal->m_type).m_schema_item_map_type)
+		if (m_internal->is_on_map(connection->get().m_items[0]->get().m_schema_item))
 		{
-			auto scene_item = new MapSceneItemConnectionItem(m_internal->m_editor_interface, m_internal->m_instance, connection);
-			m_internal->m_item_types.insert(scene_item, MapSceneItemType::Connection);
-			addItem(scene_item);
+			add_connection_item(m_internal->m_instance, connection);
 		}
 	}
 
 	void MapScene::slot_instance_connection_to_be_removed(int index)
 	{
-		auto connection = m_internal->m_instance->connections()[index];
-		auto scene_items = this->items();
+		auto scene_item = m_internal->m_connection_items.value(m_internal->m_instance->connections()[index].get());
+		if (scene_item != nullptr)
+		{
+			remove_scene_item(scene_item);
+		}
+	}
 
-		auto it = std::find_if(scene_items.begin(), scene_items.end(), [this, connection] (QGraphicsItem* scene_item)
+	void MapScene::slot_instance_connections_batch_changed()
+	{
+		auto& connections = m_internal->m_instance->connections();
+		auto& changes = connections.get_batch_changes();
+
+		for (auto connection : changes.m_removed)
+		{
+			auto scene_item = m_internal->m_connection_items.value(connection.get());
+			if (scene_item != nullptr)
+			{
+				remove_scene_item(scene_item);
+			}
+		}
+
+		for (auto connection : changes.m_added)
 		{
-			return (get_item_type(*scene_item) == MapSceneItemType::Connection &&
-					static_cast<MapSceneItemConnectionItem*>(scene_item)->get_connection() == connection);
-		});
+			slot_instance_connection_added(connections.index_of(connection));
+		}
+	}
+
+
+
+	//================================================================================
+	// Instance Slots
+	//================================================================================
+
+	void MapScene::slot_instance_item_modified(const InstanceItem* instance_item)
+	{
+		auto scene_item = m_internal->m_instance_items.value(instance_item);
+		if (scene_item != nullptr)
+		{
+			scene_item->cache();
+		}
+	}
+
+	void MapScene::slot_instance_accessibility_changed(const QVector<InstanceItemCPtr>& instance_items)
+	{
+		for (auto instance_item : instance_items)
+		{
+			slot_instance_item_modified(instance_item.get());
+		}
+	}
+
 
-		if (it != scene_items.end())
+
+	//================================================================================
+	// Helpers
+	//================================================================================
+
+	void MapScene::add_schema_item(SchemaItemPtr schema_item)
+	{
+		auto scene_item = new MapSceneItemSchemaItem(m_internal->m_editor_interface, schema_item);
+		m_internal->m_item_types.insert(scene_item, MapSceneItemType::SchemaItem);
+		m_internal->m_schema_items.insert(schema_item.get(), scene_item);
+		addItem(scene_item);
+	}
+
+	void MapScene::add_instance_item(InstancePtr instance, InstanceItemPtr instance_item)
+	{
+		auto scene_item = new MapSceneItemInstanceItem(m_internal->m_editor_interface, instance, instance_item);
+		m_internal->m_item_types.insert(scene_item, MapSceneItemType::InstanceItem);
+		m_internal->m_instance_items.insert(instance_item.get(), scene_item);
+		addItem(scene_item);
+	}
+
+	void MapScene::add_connection_item(InstancePtr instance, InstanceConnectionPtr connection)
+	{
+		auto scene_item = new MapSceneItemConnectionItem(m_internal->m_editor_interface, instance, connection);
+		m_internal->m_item_types.insert(scene_item, MapSceneItemType::Connection);
+		m_internal->m_connection_items.insert(connection.get(), scene_item);
+		addItem(scene_item);
+	}
+
+	void MapScene::remove_scene_item(QGraphicsItem* scene_item)
+	{
+		switch (get_item_type(*scene_item))
 		{
-			removeItem(*it);
-			delete_later(*it);
+		case MapSceneItemType::SchemaItem:
+			m_internal->m_schema_items.remove(static_cast<MapSceneItemSchemaItem*>(scene_item)->get_schema_item().get());
+			break;
+
+		case MapSceneItemType::InstanceItem:
+			m_internal->m_instance_items.remove(static_cast<MapSceneItemInstanceItem*>(scene_item)->get_instance_item().get());
+			break;
+
+		case MapSceneItemType::Connection:
+			m_internal->m_connection_items.remove(static_cast<MapSceneItemConnectionItem*>(scene_item)->get_connection().get());
+			break;
+
+		case MapSceneItemType::Background:
+			break;
 		}
+
+		m_internal->m_item_types.remove(scene_item);
+
+		removeItem(scene_item);
+		delete_later(scene_item);
+	}
+
+	void MapScene::clear_scene_items()
+	{
+		removeItem(m_internal->m_bg_item);
+		clear();
+		addItem(m_internal->m_bg_item);
+
+		m_internal->m_item_types.clear();
+		m_internal->m_item_types.insert(m_internal->m_bg_item, MapSceneItemType::Background);
+		m_internal->m_schema_items.clear();
+		m_internal->m_instance_items.clear();
+		m_internal->m_connection_items.clear();
 	}
 }
\ No newline at end of file
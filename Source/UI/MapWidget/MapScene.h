@@ -2,6 +2,7 @@
 #define MAP_SCENE_H
 
 // Project includes
+#include "Data/Instance/InstanceTypeInfo.h"
 #include "Data/Schema/SchemaData.h"
 #include "EditorTypeInfo.h"
 #include "Utility/EnumReflection.h"
@@ -64,6 +65,9 @@ namespace LTTPMapTracker
 		MapSceneType			get_type								() const;
 		MapSceneItemType		get_item_type							(const QGraphicsItem& item) const;
 
+		// Z Order
+		void					raise_item								(QGraphicsItem& item);
+
 		// Schema
 		void					set_schema								(SchemaPtr schema);
 		void					clear_schema							();
@@ -82,8 +86,20 @@ namespace LTTPMapTracker
 		void					slot_schema_item_modified				(int index);
 		void					slot_instance_connection_added			(int index);
 		void					slot_instance_connection_to_be_removed	(int index);
+		void					slot_instance_connections_batch_changed	();
+
+		// Instance Slots
+		void					slot_instance_item_modified				(const InstanceItem* instance_item);
+		void					slot_instance_accessibility_changed		(const QVector<InstanceItemCPtr>& instance_items);
 
 	private:
+		// Helpers
+		void					add_schema_item							(SchemaItemPtr schema_item);
+		void					add_instance_item						(InstancePtr instance, InstanceItemPtr instance_item);
+		void					add_connection_item						(InstancePtr instance, InstanceConnectionPtr connection);
+		void					remove_scene_item						(QGraphicsItem* scene_item);
+		void					clear_scene_items						();
+
 		struct Internal;
 		const std::unique_ptr<Internal> m_internal;
 	};
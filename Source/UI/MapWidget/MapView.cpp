@@ -87,7 +87,6 @@ namespace LTTPMapTracker
 	{
 		clear_instance();
 
-		QObject::connect(instance.get(), &Instance::signal_accessibility_cached, this, (void(MapView::*)())&MapView::update);
 		m_internal->m_instance = instance;
 	}
 
@@ -147,17 +146,9 @@ namespace LTTPMapTracker
 						auto instance_item_a = m_internal->m_connecting_item->get_instance_item();
 						auto instance_item_b = static_cast<MapSceneItemInstanceItem*>(item)->get_instance_item();
 
-						if (instance_item_a != instance_item_b)
+						if (instance_item_a != instance_item_b && !m_internal->m_instance->is_connected(instance_item_a, instance_item_b))
 						{
-							auto connections = m_internal->m_instance->connections().get();
-							if (std::none_of(connections.begin(), connections.end(), [instance_item_a, instance_item_b] (InstanceConnectionCPtr connection)
-							{
-								return (connection->get().m_items.contains(instance_item_a) &&
-										connection->get().m_items.contains(instance_item_b));
-							}))
-							{
-								m_internal->m_instance->connections().add({instance_item_a, instance_item_b});
-							}
+							m_internal->m_instance->connections().add({instance_item_a, instance_item_b});
 						}
 					}
 				}
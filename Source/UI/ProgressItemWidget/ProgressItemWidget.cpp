@@ -216,6 +216,9 @@ namespace LTTPMapTracker
 
 	void ProgressItemWidget::sync_to_progress(EntityWidgetItem* entity_item)
 	{
+		// Re-evaluate accessibility once for the whole tier rather than per add/remove.
+		ScopedBatch<Instance> batch(*m_internal->m_instance);
+
 		// Clear old data.
 		auto entities = entity_item->get_entities();
 		for (auto entity : entities)
@@ -113,7 +113,7 @@ namespace LTTPMapTracker
 
 	void SchemaItemWidget::select_item(SchemaItemPtr item)
 	{
-		auto index = m_internal->m_list_proxy.mapFromSource(m_internal->m_list_model.index(m_internal->m_schema->items().get().indexOf(item), 0));
+		auto index = m_internal->m_list_proxy.mapFromSource(m_internal->m_list_model.index(m_internal->m_schema->items().index_of(item), 0));
 
 		m_internal->m_list_view->clearSelection();
 		m_internal->m_list_view->setCurrentIndex(index);
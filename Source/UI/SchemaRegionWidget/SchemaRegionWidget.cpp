@@ -114,7 +114,7 @@ namespace LTTPMapTracker
 
 	void SchemaRegionWidget::select_region(SchemaRegionPtr region)
 	{
-		auto index = m_internal->m_list_proxy.mapFromSource(m_internal->m_list_model.index(m_internal->m_schema->regions().get().indexOf(region), 0));
+		auto index = m_internal->m_list_proxy.mapFromSource(m_internal->m_list_model.index(m_internal->m_schema->regions().index_of(region), 0));
 
 		m_internal->m_list_view->clearSelection();
 		m_internal->m_list_view->setCurrentIndex(index);
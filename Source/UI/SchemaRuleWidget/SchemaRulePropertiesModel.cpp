@@ -410,6 +410,8 @@ namespace LTTPMapTracker
 			rule_entry.m_operator = EnumReflection<SchemaRuleOperator>::info(value.value<ModelData>()[0].get_value().toInt()).m_type;
 		}
 
+		rule_entry.resolve(m_internal->m_editor_interface.get_data_model().get_entity_db());
+
 		auto rule_data = m_internal->m_rule->get();
 		rule_data.m_entries[index.row()] = rule_entry;
 		m_internal->m_rule->set(rule_data);
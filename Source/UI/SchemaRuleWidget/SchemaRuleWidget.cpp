@@ -120,7 +120,7 @@ namespace LTTPMapTracker
 
 	void SchemaRuleWidget::select_rule(SchemaRulePtr rule)
 	{
-		auto index = m_internal->m_list_proxy.mapFromSource(m_internal->m_list_model.index(m_internal->m_schema->rules().get().indexOf(rule), 0));
+		auto index = m_internal->m_list_proxy.mapFromSource(m_internal->m_list_model.index(m_internal->m_schema->rules().index_of(rule), 0));
 
 		m_internal->m_list_view->clearSelection();
 		m_internal->m_list_view->setCurrentIndex(index);
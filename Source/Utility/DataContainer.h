@@ -7,6 +7,7 @@
 #include "Utility/Utility.h"
 
 // Qt includes
+#include <QHash>
 #include <QObject>
 #include <QVector>
 
@@ -23,11 +24,42 @@ namespace Utility
 	// Base
 	//--------------------------------------------------------------------------------
 
+	// While a batch is open the per-index signals are held back and the changes queued by
+	// entry instead; closing the outermost batch emits signal_batch_changed once, during
+	// which the derived container's get_batch_changes() lists them.
+
 	class DataContainerBase : public QObject
 						    , public std::enable_shared_from_this<DataContainerBase>
 	{
 		Q_OBJECT
 
+	public:
+		DataContainerBase()
+			: m_batch_depth(0)
+		{
+		}
+
+		void begin_batch()
+		{
+			++m_batch_depth;
+		}
+
+		void end_batch()
+		{
+			Q_ASSERT(m_batch_depth > 0);
+
+			if (--m_batch_depth == 0 && has_batch_changes())
+			{
+				emit signal_batch_changed();
+				clear_batch_changes();
+			}
+		}
+
+		bool is_batching() const
+		{
+			return (m_batch_depth > 0);
+		}
+
 	signals:
 		void signal_to_be_added		(int index);
 		void signal_added			(int index);
@@ -36,6 +68,42 @@ namespace Utility
 		void signal_modified		(int index);
 		void signal_to_be_cleared	();
 		void signal_cleared			();
+		void signal_batch_changed	();
+
+	protected:
+		virtual bool has_batch_changes		() const = 0;
+		virtual void clear_batch_changes	() = 0;
+
+	private:
+		int m_batch_depth;
+	};
+
+
+	// Scoped Batch
+	//--------------------------------------------------------------------------------
+
+	// Holds a batch open on anything with begin_batch/end_batch for the lifetime of the scope.
+
+	template <typename T>
+	class ScopedBatch
+	{
+	public:
+		explicit ScopedBatch(T& target)
+			: m_target(target)
+		{
+			m_target.begin_batch();
+		}
+
+		~ScopedBatch()
+		{
+			m_target.end_batch();
+		}
+
+		ScopedBatch(const ScopedBatch&) = delete;
+		ScopedBatch& operator=(const ScopedBatch&) = delete;
+
+	private:
+		T& m_target;
 	};
 
 
@@ -53,6 +121,15 @@ namespace Utility
 		using DataCreator = std::function<DataPtr(Args... args)>;
 		using DataCreatorEmpty = std::function<DataPtr()>;
 
+		// Entries changed during a batch. An entry added and removed again within the batch
+		// is left out, and added entries aren't listed as modified as well.
+		struct BatchChanges
+		{
+			DataCList m_added;
+			DataCList m_removed;
+			DataCList m_modified;
+		};
+
 		DataContainer(DataCreator creator, DataCreatorEmpty creator_empty)
 			: m_creator(creator)
 			, m_creator_empty(creator_empty)
@@ -62,34 +139,66 @@ namespace Utility
 		DataPtr add(Args... args)
 		{
 			auto data = m_creator(args...);
+
+			if (is_batching())
+			{
+				insert_data(data);
+				m_batch_changes.m_added << data;
+				return data;
+			}
+
 			int index = m_data.size();
 			emit signal_to_be_added(index);
-			m_data << data;
-			m_cdata << data;
-			connect(data.get(), &DataWrapperBase::signal_modified, this, [this, data] () { emit signal_modified(m_data.indexOf(data)); });
+			insert_data(data);
 			emit signal_added(index);
 			return data;
 		}
 
 		void remove(DataPtr data)
 		{
-			Q_ASSERT(m_data.contains(data));
-			int index = m_data.indexOf(data);
+			int index = index_of(data);
+			Q_ASSERT(index != -1);
+
+			if (is_batching())
+			{
+				remove_data(index);
+				batch_removed(data);
+				return;
+			}
+
 			emit signal_to_be_removed(index);
-			m_data.removeAt(index);
-			m_cdata.removeAt(index);
-			data->disconnect(this);
+			remove_data(index);
 			emit signal_removed(index);
 		}
 
 		void clear()
 		{
+			if (is_batching())
+			{
+				for (auto data : m_data)
+				{
+					batch_removed(data);
+				}
+
+				clear_data();
+				return;
+			}
+
 			emit signal_to_be_cleared();
-			m_data.clear();
-			m_cdata.clear();
+			clear_data();
 			emit signal_cleared();
 		}
 
+		const BatchChanges& get_batch_changes() const
+		{
+			return m_batch_changes;
+		}
+
+		int index_of(const DataCPtr& data) const
+		{
+			return (data != nullptr ? m_positions.value(data.get(), -1) : -1);
+		}
+
 		const QVector<DataPtr>& get()
 		{
 			return m_data;
@@ -110,24 +219,23 @@ namespace Utility
 			return m_data[index];
 		}
 
-		template <typename... Args>
-		void serialise(QString name, QJsonObject& json, Args&&... args)
+		template <typename... SerialiseArgs>
+		void serialise(QString name, QJsonObject& json, SerialiseArgs&&... args)
 		{
 			QJsonArray json_data_list;
 			for (auto data : m_data)
 			{
 				QJsonObject json_data;
-				data->serialise(json_data, std::forward<Args>(args)...);
+				data->serialise(json_data, std::forward<SerialiseArgs>(args)...);
 				json_data_list << json_data;
 			}
 			json[name] = json_data_list;
 		};
 
-		template <typename... Args>
-		Result deserialise(QString name, const QJsonObject& json, int version, Args&&... args)
+		template <typename... SerialiseArgs>
+		Result deserialise(QString name, const QJsonObject& json, int version, SerialiseArgs&&... args)
 		{
-			m_data.clear();
-			m_cdata.clear();
+			clear_data();
 
 			Result result;
 
@@ -138,14 +246,12 @@ namespace Utility
 			for (auto json_data : json_data_list)
 			{
 				auto data = m_creator_empty();
-				auto data_result = data->deserialise(json_data.toObject(), version, std::forward<Args>(args)...);
+				auto data_result = data->deserialise(json_data.toObject(), version, std::forward<SerialiseArgs>(args)...);
 				result << data_result;
 
 				if (data_result)
 				{
-					connect(data.get(), &DataWrapperBase::signal_modified, this, [this, data] () { emit signal_modified(m_data.indexOf(data)); });
-					m_data << data;
-					m_cdata << data;
+					insert_data(data);
 				}
 			}
 
@@ -153,25 +259,144 @@ namespace Utility
 		};
 
 	protected:
-		QVector<DataPtr>  m_data;
-		QVector<DataCPtr> m_cdata;
-		DataCreator		  m_creator;
-		DataCreatorEmpty  m_creator_empty;
+		// Index hooks for derived containers, called before the matching signal goes out.
+		virtual void index_added		(const DataPtr& /*data*/)	{}
+		virtual void index_removed		(const DataPtr& /*data*/)	{}
+		virtual void index_modified		(const DataPtr& /*data*/)	{}
+		virtual void index_cleared		()							{}
+
+		bool has_batch_changes() const override
+		{
+			return (!m_batch_changes.m_added.isEmpty() || !m_batch_changes.m_removed.isEmpty() || !m_batch_changes.m_modified.isEmpty());
+		}
+
+		void clear_batch_changes() override
+		{
+			m_batch_changes = BatchChanges();
+		}
+
+		QVector<DataPtr>	  m_data;
+		QVector<DataCPtr>	  m_cdata;
+		QHash<const T*, int>  m_positions;
+		DataCreator			  m_creator;
+		DataCreatorEmpty	  m_creator_empty;
+		BatchChanges		  m_batch_changes;
+
+	private:
+		void insert_data(DataPtr data)
+		{
+			m_positions.insert(data.get(), m_data.size());
+			m_data << data;
+			m_cdata << data;
+
+			auto raw_data = data.get();
+			connect(data.get(), &DataWrapperBase::signal_modified, this, [this, raw_data] ()
+			{
+				int index = m_positions.value(raw_data, -1);
+				if (index != -1)
+				{
+					index_modified(m_data[index]);
+
+					if (is_batching())
+					{
+						batch_modified(m_data[index]);
+					}
+					else
+					{
+						emit signal_modified(index);
+					}
+				}
+			});
+
+			index_added(data);
+		}
+
+		void remove_data(int index)
+		{
+			auto data = m_data[index];
+			m_data.removeAt(index);
+			m_cdata.removeAt(index);
+			m_positions.remove(data.get());
+			for (int i = index; i < m_data.size(); ++i)
+			{
+				m_positions[m_data[i].get()] = i;
+			}
+			data->disconnect(this);
+			index_removed(data);
+		}
+
+		void batch_removed(const DataCPtr& data)
+		{
+			m_batch_changes.m_modified.removeOne(data);
+
+			if (!m_batch_changes.m_added.removeOne(data))
+			{
+				m_batch_changes.m_removed << data;
+			}
+		}
+
+		void batch_modified(const DataCPtr& data)
+		{
+			if (!m_batch_changes.m_added.contains(data) && !m_batch_changes.m_modified.contains(data))
+			{
+				m_batch_changes.m_modified << data;
+			}
+		}
+
+		void clear_data()
+		{
+			for (auto data : m_data)
+			{
+				data->disconnect(this);
+			}
+
+			m_data.clear();
+			m_cdata.clear();
+			m_positions.clear();
+			index_cleared();
+		}
+	};
+
+
+	// Data Container Key
+	//--------------------------------------------------------------------------------
+
+	// Maps a search type onto something QHash can key on; shared pointers key on their address.
+
+	template <typename T>
+	struct DataContainerKey
+	{
+		using Type = T;
+		static Type get(const T& value) { return value; }
+	};
+
+	template <typename T>
+	struct DataContainerKey<std::shared_ptr<T>>
+	{
+		using Type = const T*;
+		static Type get(const std::shared_ptr<T>& value) { return value.get(); }
 	};
 
 
 	// Searchable Data Container
 	//--------------------------------------------------------------------------------
 
+	// Keeps a hashed index from key to entry. The key delegate lists the keys an entry can be
+	// found under and is re-run whenever the entry is modified.
+
 	template <typename T, typename SearchType, typename... Args>
 	class SearchableDataContainer : public DataContainer<T, Args...>
 	{
 	public:
-		using SearchDelegate = std::function<bool(DataCPtr, SearchType)>;
+		using typename DataContainer<T, Args...>::DataPtr;
+		using typename DataContainer<T, Args...>::DataCPtr;
+		using typename DataContainer<T, Args...>::DataCreator;
+		using typename DataContainer<T, Args...>::DataCreatorEmpty;
+		using KeyDelegate = std::function<QVector<SearchType>(DataCPtr)>;
 
-		SearchableDataContainer(DataCreator creator, DataCreatorEmpty creator_empty, SearchDelegate search_delegate)
+		SearchableDataContainer(DataCreator creator, DataCreatorEmpty creator_empty, KeyDelegate key_delegate)
 			: DataContainer<T, Args...>(creator, creator_empty)
-			, m_search_delegate(search_delegate)
+			, m_key_delegate(key_delegate)
 		{
 		}
 
@@ -182,20 +407,65 @@ namespace Utility
 
 		DataCPtr find(const SearchType& id) const
 		{
-			auto it = std::find_if(m_data.begin(), m_data.end(), [this, &id] (DataCPtr data)
+			// Several entries may share a key; the earliest wins, as a front-to-back search would.
+			int index = -1;
+
+			auto key = DataContainerKey<SearchType>::get(id);
+			for (auto it = m_index.find(key); it != m_index.end() && it.key() == key; ++it)
 			{
-				return m_search_delegate(data, id);
-			});
-			return (it != m_data.end() ? *it : nullptr);
+				int position = this->m_positions.value(it.value(), -1);
+				if (position != -1 && (index == -1 || position < index))
+				{
+					index = position;
+				}
+			}
+
+			return (index != -1 ? this->m_cdata[index] : nullptr);
 		}
 
 		bool contains(const SearchType& id) const
 		{
-			return (find(id) != nullptr);
+			return m_index.contains(DataContainerKey<SearchType>::get(id));
+		}
+
+	protected:
+		void index_added(const DataPtr& data) override
+		{
+			QVector<Key> keys;
+			for (auto& key : m_key_delegate(data))
+			{
+				keys << DataContainerKey<SearchType>::get(key);
+				m_index.insert(keys.back(), data.get());
+			}
+			m_keys.insert(data.get(), keys);
+		}
+
+		void index_removed(const DataPtr& data) override
+		{
+			for (auto& key : m_keys.take(data.get()))
+			{
+				m_index.remove(key, data.get());
+			}
+		}
+
+		void index_modified(const DataPtr& data) override
+		{
+			index_removed(data);
+			index_added(data);
+		}
+
+		void index_cleared() override
+		{
+			m_index.clear();
+			m_keys.clear();
 		}
 
 	private:
-		SearchDelegate m_search_delegate;
+		using Key = typename DataContainerKey<SearchType>::Type;
+
+		KeyDelegate						m_key_delegate;
+		QMultiHash<Key, const T*>		m_index;
+		QHash<const T*, QVector<Key>>	m_keys;
 	};
 }
 
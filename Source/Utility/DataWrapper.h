@@ -17,6 +17,22 @@ class QJsonObject;
 
 namespace Utility
 {
+	// Fields
+	//--------------------------------------------------------------------------------
+
+	// One bit per field of the wrapped data. Data types can describe their fields by
+	// overloading get_changed_fields in their own namespace; anything else reports every
+	// field as changed.
+	using DataFields = quint32;
+	static const DataFields DataFieldsAll = ~DataFields(0);
+
+	template <typename T>
+	DataFields get_changed_fields(const T& /*before*/, const T& /*after*/)
+	{
+		return DataFieldsAll;
+	}
+
+
 	// Base
 	//--------------------------------------------------------------------------------
 
@@ -26,7 +42,7 @@ namespace Utility
 		Q_OBJECT
 
 	signals:
-		void signal_modified();
+		void signal_modified(DataFields fields = DataFieldsAll);
 	};
 
 
@@ -44,8 +60,12 @@ namespace Utility
 
 		void set(const T& data)
 		{
-			m_data = data;
-			emit signal_modified();
+			auto fields = get_changed_fields(m_data, data);
+			if (fields != 0)
+			{
+				m_data = data;
+				emit signal_modified(fields);
+			}
 		}
 
 	protected:
@@ -2,24 +2,44 @@
 #include "Utility/File.h"
 
 // Qt includes
-#include <QApplication>
+#include <QCoreApplication>
 #include <QFileInfo>
 
 
 namespace Utility
 {
+	//================================================================================
+	// Internal
+	//================================================================================
+
+	// Relative paths resolve against the executable's directory unless told otherwise.
+	static QString s_base_path;
+
+
+
 	//================================================================================
 	// Path
 	//================================================================================
 
+	void set_base_path(QString path)
+	{
+		s_base_path = path;
+	}
+
+	QString get_base_path()
+	{
+		return (!s_base_path.isEmpty() ? s_base_path : QCoreApplication::applicationDirPath());
+	}
+
 	QString get_relative_path(QString path)
 	{
-		return (path.startsWith(QApplication::applicationDirPath()) ? path.mid(QApplication::applicationDirPath().length() + 1) : path);
+		auto base_path = get_base_path();
+		return (path.startsWith(base_path) ? path.mid(base_path.length() + 1) : path);
 	}
 
 	QString get_absolute_path(QString path)
 	{
-		return (!path.isEmpty() && !QFileInfo(path).isAbsolute() ? QApplication::applicationDirPath() + "/" + path : path);
+		return (!path.isEmpty() && !QFileInfo(path).isAbsolute() ? get_base_path() + "/" + path : path);
 	}
 
 	bool is_absolute_path(QString path)
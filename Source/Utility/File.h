@@ -8,6 +8,9 @@
 namespace Utility
 {
 	// Path
+	void	set_base_path		(QString path);
+	QString get_base_path		();
+
 	QString get_relative_path	(QString path);
 	QString get_absolute_path	(QString path);
 
@@ -1,13 +1,6 @@
 // Project includes
 #include "Utility/Result.h"
 
-// Qt includes
-#include <QDialog>
-#include <QMessageBox>
-#include <QLayout>
-#include <QListWidget>
-#include <QWidget>
-
 
 namespace Utility
 {
@@ -103,55 +96,4 @@ namespace Utility
 	{
 		return (get_type() != ResultType::Error);
 	}
-
-
-
-	//================================================================================
-	// Utility
-	//================================================================================
-
-	void report_result(const Result& result, QWidget* parent, QString title)
-	{
-		auto type = result.get_type();
-
-		if (type != ResultType::Ok)
-		{
-			if (std::all_of(result.get_entries().begin(), result.get_entries().end(), [] (const ResultEntry& entry)
-			{
-				return entry.m_message.isEmpty();
-			}))
-			{
-				return;
-			}
-
-			if (result.get_entries().size() == 1)
-			{
-				auto& entry = result.get_entries()[0];
-
-				switch (type)
-				{
-				case ResultType::Warning: QMessageBox::warning(parent, title, entry.m_message); break;
-				case ResultType::Error: QMessageBox::critical(parent, title, entry.m_message); break;
-				}
-			}
-			else
-			{
-				QDialog d(parent);
-				d.setWindowTitle(title);
-				auto l = new QHBoxLayout();
-				l->setContentsMargins(0, 0, 0, 0);
-				d.setLayout(l);
-
-				auto list_widget = new QListWidget();
-				l->addWidget(list_widget);
-
-				for (auto& entry : result.get_entries())
-				{
-					list_widget->addItem(QString("[%1] %2").arg(get_result_type_display_name(entry.m_type)).arg(entry.m_message));
-				}
-
-				d.exec();
-			}
-		}
-	}
 }
\ No newline at end of file
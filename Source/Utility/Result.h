@@ -7,9 +7,6 @@
 // Qt includes
 #include <QVector>
 
-// Forward declarations
-class QWidget;
-
 
 namespace Utility
 {
@@ -57,12 +54,6 @@ namespace Utility
 	private:
 		ResultEntryList			m_entries;
 	};
-
-
-	// Utility
-	//--------------------------------------------------------------------------------
-
-	void report_result(const Result& result, QWidget* parent, QString title);
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,20 @@
+#ifndef UTILITY_RESULT_DIALOG_H
+#define UTILITY_RESULT_DIALOG_H
+
+// Project includes
+#include "Utility/Result.h"
+#include "Utility/Utility.h"
+
+// Forward declarations
+class QWidget;
+
+
+namespace Utility
+{
+	// Utility
+	//--------------------------------------------------------------------------------
+
+	void report_result(const Result& result, QWidget* parent, QString title);
+}
+
+#endif
\ No newline at end of file